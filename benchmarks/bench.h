@@ -0,0 +1,51 @@
+#ifndef BENCHMARKS_BENCH_H_
+#define BENCHMARKS_BENCH_H_
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace bench {
+
+inline unsigned max_threads() {
+  unsigned threads = std::thread::hardware_concurrency();
+  return threads == 0 ? 1 : threads;
+}
+
+// 1, 2, 4, ... up to and including max_threads().
+inline std::vector<unsigned> thread_counts() {
+  std::vector<unsigned> counts;
+  for (unsigned n = 1; n < max_threads(); n *= 2) counts.push_back(n);
+  counts.push_back(max_threads());
+  return counts;
+}
+
+template <typename Fn>
+double seconds(Fn&& fn) {
+  auto start = std::chrono::steady_clock::now();
+  fn();
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+// Runs fn(thread_index) on `threads` threads and returns the wall time.
+template <typename Fn>
+double run_threads(unsigned threads, Fn fn) {
+  return seconds([&] {
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < threads; ++i) workers.emplace_back(fn, i);
+    for (auto& worker : workers) worker.join();
+  });
+}
+
+inline void report(const char* name, unsigned threads, double operations,
+                   double elapsed) {
+  std::printf("%-36s threads=%-3u %10.2f Mops/s\n", name, threads,
+              operations / elapsed / 1e6);
+}
+
+}  // namespace bench
+
+#endif  // BENCHMARKS_BENCH_H_
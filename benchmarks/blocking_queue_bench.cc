@@ -0,0 +1,68 @@
+#include <cstdio>
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "../lace_blocking_queue.h"
+#include "bench.h"
+
+namespace {
+
+constexpr int kMessagesPerProducer = 1 << 18;
+constexpr int kRoundTrips = 1 << 14;
+
+// pairs producers push into one queue and pairs consumers take the messages
+// out, one at a time or drain()ing batches of up to 64.
+double throughput(unsigned pairs, size_t capacity, bool batched) {
+  lace::blocking_queue<int> q(capacity);
+  return bench::run_threads(2 * pairs, [&](unsigned t) {
+    if (t < pairs) {
+      for (int i = 0; i < kMessagesPerProducer; ++i) q.push(i);
+      return;
+    }
+    int value;
+    std::vector<int> batch(64);
+    for (int received = 0; received < kMessagesPerProducer;) {
+      if (batched) {
+        size_t want = std::min<size_t>(64, kMessagesPerProducer - received);
+        received += int(q.drain(batch.begin(), want));
+      } else if (q.pop(value)) {
+        ++received;
+      }
+    }
+  });
+}
+
+}  // namespace
+
+int main() {
+  for (unsigned pairs : bench::thread_counts()) {
+    double ops = double(pairs) * kMessagesPerProducer;
+    bench::report("blocking_queue unbounded pop", 2 * pairs, ops,
+                  throughput(pairs, lace::blocking_queue<int>::kUnbounded,
+                             false));
+    bench::report("blocking_queue bounded(256) pop", 2 * pairs, ops,
+                  throughput(pairs, 256, false));
+    bench::report("blocking_queue bounded(256) drain", 2 * pairs, ops,
+                  throughput(pairs, 256, true));
+  }
+
+  // Latency: a ping-pong between two threads over two queues.
+  lace::blocking_queue<int> ping;
+  lace::blocking_queue<int> pong;
+  std::thread echo([&] {
+    int value;
+    while (ping.pop(value)) pong.push(value);
+  });
+  double elapsed = bench::seconds([&] {
+    int value;
+    for (int i = 0; i < kRoundTrips; ++i) {
+      ping.push(i);
+      pong.pop(value);
+    }
+  });
+  ping.close();
+  echo.join();
+  std::printf("%-36s %10.2f us\n", "blocking_queue round trip",
+              elapsed / kRoundTrips * 1e6);
+}
@@ -0,0 +1,51 @@
+#include "../lace_channel.h"
+#include "../lace_queue.h"
+#include "bench.h"
+
+namespace {
+
+constexpr int kMessages = 1 << 22;
+
+lace::job produce(lace::channel<int>& ch) {
+  for (int i = 0; i < kMessages; ++i) co_await ch.send(i);
+  ch.close();
+}
+
+lace::job consume(lace::channel<int>& ch, long& sum) {
+  while (auto value = co_await ch.recv()) sum += *value;
+}
+
+double run_channel(size_t capacity, long& sum) {
+  lace::executor ex;
+  lace::channel<int> ch(ex, capacity);
+  return bench::seconds([&] {
+    ex.spawn(consume(ch, sum));
+    ex.spawn(produce(ch));
+    ex.run();
+  });
+}
+
+}  // namespace
+
+int main() {
+  volatile long sink = 0;
+  long sum = 0;
+  double elapsed = bench::seconds([&] {
+    lace::queue<int> q;
+    for (int i = 0; i < kMessages; ++i) {
+      q.push(i);
+      sum += q.front();
+      q.pop();
+    }
+  });
+  bench::report("lace::queue push+pop", 1, kMessages, elapsed);
+
+  elapsed = run_channel(lace::channel<int>::kUnbounded, sum);
+  bench::report("lace::channel unbounded", 1, kMessages, elapsed);
+  elapsed = run_channel(64, sum);
+  bench::report("lace::channel capacity 64", 1, kMessages, elapsed);
+  elapsed = run_channel(0, sum);
+  bench::report("lace::channel capacity 0", 1, kMessages, elapsed);
+  sink = sum;
+  (void)sink;
+}
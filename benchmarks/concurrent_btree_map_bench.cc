@@ -0,0 +1,69 @@
+#include <random>
+
+#include "../lace_concurrent_btree_map.h"
+#include "../lace_concurrent_skiplist_map.h"
+#include "bench.h"
+
+namespace {
+
+constexpr int kKeys = 1 << 20;
+constexpr int kOpsPerThread = 1 << 18;
+constexpr int kScanLength = 100;
+
+// 80% lookups, 10% inserts, 10% erases over a half-full key space.
+template <typename Map>
+void mixed_workload(Map& m, unsigned thread) {
+  std::mt19937 gen(thread);
+  std::uniform_int_distribution<int> key(0, kKeys - 1);
+  for (int i = 0; i < kOpsPerThread; ++i) {
+    switch (i % 10) {
+      case 0:
+        m.insert(key(gen), i);
+        break;
+      case 1:
+        m.erase(key(gen));
+        break;
+      default:
+        m.contains(key(gen));
+    }
+  }
+}
+
+// Short ordered scans starting at random keys.
+template <typename Map>
+long scan_workload(const Map& m, unsigned thread) {
+  std::mt19937 gen(thread);
+  std::uniform_int_distribution<int> key(0, kKeys - 1);
+  long sum = 0;
+  for (int i = 0; i < kOpsPerThread / kScanLength; ++i) {
+    auto it = m.lower_bound(key(gen));
+    for (int j = 0; j < kScanLength && it != m.end(); ++j, ++it) {
+      sum += it->second;
+    }
+  }
+  return sum;
+}
+
+template <typename Map>
+void run(const char* name) {
+  for (unsigned threads : bench::thread_counts()) {
+    Map m;
+    for (int i = 0; i < kKeys; i += 2) m.insert(i, i);
+    double elapsed =
+        bench::run_threads(threads, [&](unsigned t) { mixed_workload(m, t); });
+    bench::report(name, threads, double(threads) * kOpsPerThread, elapsed);
+
+    elapsed = bench::run_threads(threads,
+                                 [&](unsigned t) { scan_workload(m, t); });
+    bench::report("  scanned entries", threads,
+                  double(threads) * kOpsPerThread, elapsed);
+  }
+}
+
+}  // namespace
+
+int main() {
+  run<lace::concurrent_skiplist_map<int, int>>("lace::concurrent_skiplist_map");
+  run<lace::concurrent_btree_map<int, int>>("lace::concurrent_btree_map");
+  return 0;
+}
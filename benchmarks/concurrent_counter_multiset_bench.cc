@@ -0,0 +1,47 @@
+#include <mutex>
+#include <random>
+
+#include "../lace_concurrent_counter_multiset.h"
+#include "../lace_multiset.h"
+#include "bench.h"
+
+namespace {
+
+constexpr int kKeys = 1 << 12;
+constexpr int kOpsPerThread = 1 << 18;
+
+// Skewed keys: half of all increments go to eight hot keys.
+template <typename Add>
+void count_events(unsigned thread, Add add) {
+  std::mt19937 gen(thread);
+  std::uniform_int_distribution<int> key(0, kKeys - 1);
+  for (int i = 0; i < kOpsPerThread; ++i) {
+    add(i % 2 == 0 ? i % 8 : key(gen));
+  }
+}
+
+}  // namespace
+
+int main() {
+  for (unsigned threads : bench::thread_counts()) {
+    lace::multiset<int> counts;
+    std::mutex mutex;
+    double elapsed = bench::run_threads(threads, [&](unsigned t) {
+      count_events(t, [&](int k) {
+        std::lock_guard<std::mutex> lock(mutex);
+        counts.insert(k);
+      });
+    });
+    bench::report("mutex + lace::multiset", threads,
+                  double(threads) * kOpsPerThread, elapsed);
+  }
+
+  for (unsigned threads : bench::thread_counts()) {
+    lace::concurrent_counter_multiset<int> counts;
+    double elapsed = bench::run_threads(threads, [&](unsigned t) {
+      count_events(t, [&](int k) { counts.insert(k); });
+    });
+    bench::report("lace::concurrent_counter_multiset", threads,
+                  double(threads) * kOpsPerThread, elapsed);
+  }
+}
@@ -0,0 +1,88 @@
+#include <mutex>
+#include <random>
+
+#include "../lace_concurrent_skiplist_map.h"
+#include "../lace_hazard_pointer.h"
+#include "../lace_map.h"
+#include "bench.h"
+
+namespace {
+
+constexpr int kKeys = 1 << 16;
+constexpr int kOpsPerThread = 1 << 18;
+
+// Write-heavy: 25% inserts, 25% erases, 50% lookups over a half-full key
+// space.
+template <typename Lookup, typename Insert, typename Erase>
+void write_heavy_workload(unsigned thread, Lookup lookup, Insert insert,
+                          Erase erase) {
+  std::mt19937 gen(thread);
+  std::uniform_int_distribution<int> key(0, kKeys - 1);
+  for (int i = 0; i < kOpsPerThread; ++i) {
+    switch (i % 4) {
+      case 0:
+        insert(key(gen), i);
+        break;
+      case 1:
+        erase(key(gen));
+        break;
+      default:
+        lookup(key(gen));
+    }
+  }
+}
+
+}  // namespace
+
+int main() {
+  for (unsigned threads : bench::thread_counts()) {
+    lace::map<int, int> single;
+    std::mutex mutex;
+    for (int i = 0; i < kKeys; i += 2) single.insert(i, i);
+    double elapsed = bench::run_threads(threads, [&](unsigned t) {
+      write_heavy_workload(
+          t,
+          [&](int k) {
+            std::lock_guard<std::mutex> lock(mutex);
+            return single.contains(k);
+          },
+          [&](int k, int v) {
+            std::lock_guard<std::mutex> lock(mutex);
+            single.insert(k, v);
+          },
+          [&](int k) {
+            std::lock_guard<std::mutex> lock(mutex);
+            single.erase(k);
+          });
+    });
+    bench::report("mutex + lace::map", threads,
+                  double(threads) * kOpsPerThread, elapsed);
+  }
+
+  for (unsigned threads : bench::thread_counts()) {
+    lace::concurrent_skiplist_map<int, int> skiplist;
+    for (int i = 0; i < kKeys; i += 2) skiplist.insert(i, i);
+    double elapsed = bench::run_threads(threads, [&](unsigned t) {
+      write_heavy_workload(
+          t, [&](int k) { return skiplist.contains(k); },
+          [&](int k, int v) { skiplist.insert(k, v); },
+          [&](int k) { skiplist.erase(k); });
+    });
+    bench::report("lace::concurrent_skiplist_map", threads,
+                  double(threads) * kOpsPerThread, elapsed);
+  }
+
+  for (unsigned threads : bench::thread_counts()) {
+    lace::concurrent_skiplist_map<int, int, lace::hazard_pointer> skiplist;
+    for (int i = 0; i < kKeys; i += 2) skiplist.insert(i, i);
+    double elapsed = bench::run_threads(threads, [&](unsigned t) {
+      write_heavy_workload(
+          t, [&](int k) { return skiplist.contains(k); },
+          [&](int k, int v) { skiplist.insert(k, v); },
+          [&](int k) { skiplist.erase(k); });
+    });
+    bench::report("lace::concurrent_skiplist_map, hazard_pointer", threads,
+                  double(threads) * kOpsPerThread, elapsed);
+  }
+  return 0;
+}
@@ -0,0 +1,62 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+
+#include "../lace_epoch.h"
+#include "bench.h"
+
+namespace {
+
+constexpr int kOpsPerThread = 1 << 20;
+
+struct Payload {
+  long data[4] = {};
+};
+
+}  // namespace
+
+int main() {
+  for (unsigned threads : bench::thread_counts()) {
+    lace::epoch domain;
+    double elapsed = bench::run_threads(threads, [&](unsigned) {
+      for (int i = 0; i < kOpsPerThread; ++i) auto guard = domain.pin();
+    });
+    bench::report("epoch pin/unpin", threads, double(threads) * kOpsPerThread,
+                  elapsed);
+  }
+
+  for (unsigned threads : bench::thread_counts()) {
+    double elapsed = bench::run_threads(threads, [&](unsigned) {
+      for (int i = 0; i < kOpsPerThread; ++i) {
+        Payload* volatile payload = new Payload();
+        delete payload;
+      }
+    });
+    bench::report("new + delete", threads, double(threads) * kOpsPerThread,
+                  elapsed);
+  }
+
+  for (unsigned threads : bench::thread_counts()) {
+    lace::epoch domain;
+    std::atomic<size_t> peak{0};
+    double elapsed = bench::run_threads(threads, [&](unsigned) {
+      size_t local_peak = 0;
+      for (int i = 0; i < kOpsPerThread; ++i) {
+        auto guard = domain.pin();
+        domain.retire(new Payload());
+        if (i % 1024 == 0) {
+          local_peak = std::max(local_peak, domain.garbage_size());
+        }
+      }
+      size_t seen = peak.load();
+      while (seen < local_peak &&
+             !peak.compare_exchange_weak(seen, local_peak)) {
+      }
+    });
+    bench::report("new + pin + retire", threads,
+                  double(threads) * kOpsPerThread, elapsed);
+    std::printf("%-36s threads=%-3u %10zu nodes\n", "  peak garbage", threads,
+                peak.load());
+  }
+  return 0;
+}
@@ -0,0 +1,132 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#include "../lace_epoch.h"
+#include "../lace_hazard_pointer.h"
+#include "bench.h"
+
+namespace {
+
+constexpr int kOpsPerThread = 1 << 19;
+constexpr auto kStall = std::chrono::milliseconds(50);
+
+struct Node {
+  long value;
+  Node* next;
+};
+
+// Treiber stack; Protect is how pop keeps the head alive while reading it.
+template <typename Domain>
+class stack {
+ public:
+  explicit stack(Domain& domain) : domain_(domain) {}
+
+  ~stack() {
+    Node* node = head_.load();
+    while (node != nullptr) {
+      Node* next = node->next;
+      delete node;
+      node = next;
+    }
+  }
+
+  void push(long value) {
+    Node* node = new Node{value, head_.load()};
+    while (!head_.compare_exchange_weak(node->next, node)) {
+    }
+  }
+
+  bool pop(long& value);
+
+ private:
+  Domain& domain_;
+  std::atomic<Node*> head_{nullptr};
+};
+
+template <>
+bool stack<lace::epoch>::pop(long& value) {
+  auto guard = domain_.pin();
+  Node* head = head_.load();
+  while (head != nullptr && !head_.compare_exchange_weak(head, head->next)) {
+  }
+  if (head == nullptr) return false;
+  value = head->value;
+  domain_.retire(head);
+  return true;
+}
+
+template <>
+bool stack<lace::hazard_pointer>::pop(long& value) {
+  auto guard = domain_.make_guard();
+  while (true) {
+    Node* head = guard.protect(head_);
+    if (head == nullptr) return false;
+    if (head_.compare_exchange_strong(head, head->next)) {
+      value = head->value;
+      guard.reset();
+      domain_.retire(head);
+      return true;
+    }
+  }
+}
+
+// Every thread alternates push and pop. With stall set, one extra thread
+// sits inside a read-side critical section for the first kStall of the run.
+template <typename Domain, typename Stall>
+void run(const char* name, bool stall, Stall enter_stall) {
+  for (unsigned threads : bench::thread_counts()) {
+    Domain domain;
+    stack<Domain> s(domain);
+    std::atomic<bool> stalled{false};
+    std::thread staller;
+    if (stall) {
+      staller = std::thread([&] {
+        auto guard = enter_stall(domain);
+        stalled = true;
+        std::this_thread::sleep_for(kStall);
+      });
+      while (!stalled) std::this_thread::yield();
+    }
+
+    std::atomic<size_t> peak{0};
+    double elapsed = bench::run_threads(threads, [&](unsigned) {
+      size_t local_peak = 0;
+      for (int i = 0; i < kOpsPerThread; ++i) {
+        long value;
+        s.push(i);
+        s.pop(value);
+        if (i % 1000 == 0) {
+          local_peak = std::max(local_peak, domain.garbage_size());
+        }
+      }
+      size_t seen = peak.load();
+      while (seen < local_peak &&
+             !peak.compare_exchange_weak(seen, local_peak)) {
+      }
+    });
+    if (staller.joinable()) staller.join();
+    bench::report(name, threads, 2.0 * threads * kOpsPerThread, elapsed);
+    std::printf("%-36s threads=%-3u %10zu nodes\n", "  peak garbage", threads,
+                peak.load());
+  }
+}
+
+}  // namespace
+
+int main() {
+  auto pin = [](lace::epoch& domain) { return domain.pin(); };
+  auto hold = [](lace::hazard_pointer& domain) {
+    return domain.make_guard();
+  };
+  run<lace::epoch>("epoch", false, pin);
+  run<lace::hazard_pointer>("hazard_pointer", false, hold);
+  // A stalled epoch reader stops all reclamation: garbage climbs to
+  // max_garbage and writers then wait for the reader. A stalled hazard
+  // pointer holds back a single node.
+  run<lace::epoch>("epoch, stalled reader", true, pin);
+  run<lace::hazard_pointer>("hazard_pointer, stalled reader", true, hold);
+  return 0;
+}
@@ -0,0 +1,120 @@
+#include <cstdio>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../lace_intrusive_queue.h"
+#include "../lace_queue.h"
+#include "bench.h"
+
+namespace {
+
+constexpr int kOps = 1 << 22;
+constexpr int kEventsPerProducer = 1 << 19;
+
+struct event {
+  long payload = 0;
+  lace::intrusive_hook<event> hook;
+};
+
+using event_queue = lace::intrusive_queue<event, &event::hook>;
+
+// Events come from a pool; the queue hovers around `depth` of them while
+// every iteration pushes one and pops one.
+template <typename Push, typename Pop>
+void run(const char* name, int depth, Push push, Pop pop) {
+  std::vector<event> pool(depth + 1);
+  volatile long sink = 0;
+  double elapsed = bench::seconds([&] {
+    long sum = 0;
+    for (int i = 0; i < depth; ++i) push(&pool[i]);
+    event* spare = &pool[depth];
+    for (int i = 0; i < kOps; ++i) {
+      spare->payload = i;
+      push(spare);
+      spare = pop();
+      sum += spare->payload;
+    }
+    sink = sum;
+  });
+  bench::report(name, 1, 2.0 * kOps, elapsed);
+}
+
+// producers threads push their own events; one consumer takes them all.
+template <typename Push, typename TryPop>
+double fan_in(unsigned producers, Push push, TryPop try_pop) {
+  std::vector<std::vector<event>> events(
+      producers, std::vector<event>(kEventsPerProducer));
+  return bench::run_threads(producers + 1, [&](unsigned t) {
+    if (t < producers) {
+      for (auto& e : events[t]) push(&e);
+    } else {
+      long total = static_cast<long>(producers) * kEventsPerProducer;
+      for (long received = 0; received < total;) {
+        if (try_pop() != nullptr) {
+          ++received;
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    }
+  });
+}
+
+}  // namespace
+
+int main() {
+  for (int depth : {16, 4096}) {
+    std::printf("queue depth %d\n", depth);
+    lace::queue<event*, std::list<event*>> list_queue;
+    run(
+        "lace::queue<std::list>", depth,
+        [&](event* e) { list_queue.push(e); },
+        [&] {
+          event* e = list_queue.front();
+          list_queue.pop();
+          return e;
+        });
+    lace::queue<event*> ring_queue;
+    run(
+        "lace::queue<ring_buffer>", depth,
+        [&](event* e) { ring_queue.push(e); },
+        [&] {
+          event* e = ring_queue.front();
+          ring_queue.pop();
+          return e;
+        });
+    event_queue intrusive;
+    run(
+        "lace::intrusive_queue", depth,
+        [&](event* e) { intrusive.push(*e); }, [&] { return intrusive.pop(); });
+  }
+
+  for (unsigned producers : bench::thread_counts()) {
+    lace::queue<event*> q;
+    std::mutex mutex;
+    double elapsed = fan_in(
+        producers,
+        [&](event* e) {
+          std::lock_guard<std::mutex> lock(mutex);
+          q.push(e);
+        },
+        [&]() -> event* {
+          std::lock_guard<std::mutex> lock(mutex);
+          if (q.empty()) return nullptr;
+          event* e = q.front();
+          q.pop();
+          return e;
+        });
+    bench::report("mutex + lace::queue", producers + 1,
+                  double(producers) * kEventsPerProducer, elapsed);
+
+    lace::intrusive_mpsc_queue<event, &event::hook> mpsc;
+    elapsed = fan_in(
+        producers, [&](event* e) { mpsc.push(*e); },
+        [&] { return mpsc.pop(); });
+    bench::report("lace::intrusive_mpsc_queue", producers + 1,
+                  double(producers) * kEventsPerProducer, elapsed);
+  }
+}
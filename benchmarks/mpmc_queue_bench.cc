@@ -0,0 +1,63 @@
+#include <mutex>
+#include <thread>
+
+#include "../lace_mpmc_queue.h"
+#include "../lace_queue.h"
+#include "bench.h"
+
+namespace {
+
+constexpr int kMessagesPerProducer = 1 << 19;
+
+// Half of the 2 * pairs threads produce, the other half consume; each
+// consumer takes as many messages as one producer sends.
+template <typename Push, typename TryPop>
+double pump(unsigned pairs, Push push, TryPop try_pop) {
+  return bench::run_threads(2 * pairs, [&](unsigned t) {
+    if (t < pairs) {
+      for (int i = 0; i < kMessagesPerProducer; ++i) push(i);
+    } else {
+      int value;
+      for (int received = 0; received < kMessagesPerProducer;) {
+        if (try_pop(value)) {
+          ++received;
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    }
+  });
+}
+
+}  // namespace
+
+int main() {
+  for (unsigned pairs : bench::thread_counts()) {
+    lace::queue<int> q;
+    std::mutex mutex;
+    double elapsed = pump(
+        pairs,
+        [&](int value) {
+          std::lock_guard<std::mutex> lock(mutex);
+          q.push(value);
+        },
+        [&](int& value) {
+          std::lock_guard<std::mutex> lock(mutex);
+          if (q.empty()) return false;
+          value = q.front();
+          q.pop();
+          return true;
+        });
+    bench::report("mutex + lace::queue", 2 * pairs,
+                  double(pairs) * kMessagesPerProducer, elapsed);
+  }
+
+  for (unsigned pairs : bench::thread_counts()) {
+    lace::mpmc_queue<int> q(1024);
+    double elapsed = pump(
+        pairs, [&](int value) { q.push(value); },
+        [&](int& value) { return q.try_pop(value); });
+    bench::report("lace::mpmc_queue", 2 * pairs,
+                  double(pairs) * kMessagesPerProducer, elapsed);
+  }
+}
@@ -0,0 +1,46 @@
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "../lace_map.h"
+#include "../lace_parallel.h"
+#include "bench.h"
+
+namespace {
+
+constexpr int kKeys = 1 << 22;
+
+long add_value(long acc, const std::pair<const int, int>& kv) {
+  return acc + kv.second;
+}
+
+}  // namespace
+
+int main() {
+  std::vector<std::pair<int, int>> items;
+  for (int i = 0; i < kKeys; ++i) items.emplace_back(i, i % 1000);
+  auto m = lace::map<int, int>::from_sorted(items.begin(), items.end());
+
+  volatile long sink = lace::parallel_reduce(m, 0L, add_value,
+                                            std::plus<long>(), 1);
+  double elapsed = bench::seconds([&] {
+    long sum = 0;
+    for (const auto& kv : std::as_const(m)) sum = add_value(sum, kv);
+    sink = sum;
+  });
+  bench::report("iterator loop", 1, kKeys, elapsed);
+
+  for (unsigned threads : bench::thread_counts()) {
+    elapsed = bench::seconds([&] {
+      sink = lace::parallel_reduce(m, 0L, add_value, std::plus<long>(),
+                                   threads);
+    });
+    bench::report("lace::parallel_reduce", threads, kKeys, elapsed);
+    elapsed = bench::seconds([&] {
+      sink = lace::parallel_reduce_ordered(m, 0L, add_value,
+                                           std::plus<long>(), threads);
+    });
+    bench::report("lace::parallel_reduce_ordered", threads, kKeys, elapsed);
+  }
+  (void)sink;
+}
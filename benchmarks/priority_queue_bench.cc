@@ -0,0 +1,140 @@
+#include <cstdio>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "../lace_priority_queue.h"
+#include "bench.h"
+
+namespace {
+
+constexpr int kValues = 1 << 20;
+constexpr int kNodes = 1 << 17;
+constexpr int kEdgesPerNode = 8;
+
+struct edge {
+  int to;
+  long weight;
+};
+
+using graph = std::vector<std::vector<edge>>;
+
+// Pushes kValues values one by one, then pops them all.
+template <typename Queue>
+void push_pop(const char* name, const std::vector<int>& values) {
+  volatile long sink = 0;
+  double elapsed = bench::seconds([&] {
+    Queue q;
+    for (int value : values) q.push(value);
+    long sum = 0;
+    while (!q.empty()) {
+      sum += q.top();
+      q.pop();
+    }
+    sink = sum;
+  });
+  bench::report(name, 1, 2.0 * kValues, elapsed);
+}
+
+// Builds the heap from the whole range at once, then pops it all.
+template <typename Queue>
+void build_pop(const char* name, const std::vector<int>& values) {
+  volatile long sink = 0;
+  double elapsed = bench::seconds([&] {
+    Queue q(values.begin(), values.end());
+    long sum = 0;
+    while (!q.empty()) {
+      sum += q.top();
+      q.pop();
+    }
+    sink = sum;
+  });
+  bench::report(name, 1, 2.0 * kValues, elapsed);
+}
+
+// Dijkstra with a std::priority_queue: improved distances are pushed again
+// and stale entries skipped when popped.
+long dijkstra_lazy(const graph& g) {
+  std::vector<long> dist(g.size(), std::numeric_limits<long>::max());
+  std::priority_queue<std::pair<long, int>, std::vector<std::pair<long, int>>,
+                      std::greater<>>
+      q;
+  dist[0] = 0;
+  q.emplace(0, 0);
+  while (!q.empty()) {
+    auto [d, node] = q.top();
+    q.pop();
+    if (d != dist[node]) continue;
+    for (const edge& e : g[node]) {
+      if (d + e.weight < dist[e.to]) {
+        dist[e.to] = d + e.weight;
+        q.emplace(dist[e.to], e.to);
+      }
+    }
+  }
+  return dist.back();
+}
+
+// Dijkstra with promote: every node is in the heap at most once.
+long dijkstra_indexed(const graph& g) {
+  std::vector<long> dist(g.size(), std::numeric_limits<long>::max());
+  lace::indexed_priority_queue<std::pair<long, int>, std::greater<>> q;
+  std::vector<size_t> handles(g.size());
+  dist[0] = 0;
+  handles[0] = q.push({0, 0});
+  while (!q.empty()) {
+    auto [d, node] = q.top();
+    q.pop();
+    for (const edge& e : g[node]) {
+      if (d + e.weight >= dist[e.to]) continue;
+      bool queued = dist[e.to] != std::numeric_limits<long>::max();
+      dist[e.to] = d + e.weight;
+      if (queued) {
+        q.promote(handles[e.to], {dist[e.to], e.to});
+      } else {
+        handles[e.to] = q.push({dist[e.to], e.to});
+      }
+    }
+  }
+  return dist.back();
+}
+
+}  // namespace
+
+int main() {
+  std::mt19937 rng(42);
+  std::vector<int> values(kValues);
+  for (int& value : values) value = static_cast<int>(rng());
+
+  std::printf("push then pop %d ints\n", kValues);
+  push_pop<std::priority_queue<int>>("std::priority_queue", values);
+  push_pop<lace::priority_queue<int, std::less<int>, 2>>(
+      "lace::priority_queue arity 2", values);
+  push_pop<lace::priority_queue<int>>("lace::priority_queue arity 4", values);
+  push_pop<lace::priority_queue<int, std::less<int>, 8>>(
+      "lace::priority_queue arity 8", values);
+
+  std::printf("heapify then pop %d ints\n", kValues);
+  build_pop<std::priority_queue<int>>("std::priority_queue", values);
+  build_pop<lace::priority_queue<int>>("lace::priority_queue arity 4", values);
+
+  graph g(kNodes);
+  for (int node = 0; node < kNodes; ++node) {
+    for (int i = 0; i < kEdgesPerNode; ++i) {
+      g[node].push_back({static_cast<int>(rng() % kNodes),
+                         static_cast<long>(rng() % 1000 + 1)});
+    }
+  }
+  std::printf("dijkstra, %d nodes, %d edges each\n", kNodes, kEdgesPerNode);
+  volatile long sink = 0;
+  double elapsed = bench::seconds([&] { sink = dijkstra_lazy(g); });
+  bench::report("std::priority_queue, lazy deletion", 1,
+                double(kNodes) * kEdgesPerNode, elapsed);
+  elapsed = bench::seconds([&] { sink = dijkstra_indexed(g); });
+  bench::report("lace::indexed_priority_queue", 1,
+                double(kNodes) * kEdgesPerNode, elapsed);
+  (void)sink;
+}
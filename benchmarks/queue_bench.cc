@@ -0,0 +1,68 @@
+#include <cstdio>
+#include <list>
+
+#include "../lace_queue.h"
+#include "bench.h"
+
+namespace {
+
+constexpr int kOps = 1 << 22;
+constexpr int kSpike = 1 << 20;
+
+// A dispatcher-like pattern: the queue hovers around `depth` elements while
+// every iteration pushes one job and pops one.
+template <typename Queue>
+void run(const char* name, int depth) {
+  Queue q;
+  volatile long sink = 0;
+  double elapsed = bench::seconds([&] {
+    long sum = 0;
+    for (int i = 0; i < depth; ++i) q.push(i);
+    for (int i = 0; i < kOps; ++i) {
+      q.push(i);
+      sum += q.front();
+      q.pop();
+    }
+    sink = sum;
+  });
+  bench::report(name, 1, 2.0 * kOps, elapsed);
+}
+
+// Bursts: the queue fills up to kSpike elements and drains to empty, again
+// and again.
+template <typename Container>
+Container spikes(const char* name) {
+  Container c;
+  volatile long sink = 0;
+  double elapsed = bench::seconds([&] {
+    long sum = 0;
+    for (int round = 0; round < 4; ++round) {
+      for (int i = 0; i < kSpike; ++i) c.push_back(i);
+      for (int i = 0; i < kSpike; ++i) {
+        sum += c.front();
+        c.pop_front();
+      }
+    }
+    sink = sum;
+  });
+  bench::report(name, 1, 8.0 * kSpike, elapsed);
+  return c;
+}
+
+}  // namespace
+
+int main() {
+  for (int depth : {16, 4096}) {
+    std::printf("queue depth %d\n", depth);
+    run<lace::queue<int, std::list<int>>>("lace::queue<std::list>", depth);
+    run<lace::queue<int>>("lace::queue<ring_buffer>", depth);
+    run<lace::chunked_queue<int>>("lace::queue<unrolled_list>", depth);
+  }
+
+  std::printf("spikes to %d elements\n", kSpike);
+  auto ring = spikes<lace::ring_buffer<int>>("lace::ring_buffer");
+  auto chunks = spikes<lace::unrolled_list<int>>("lace::unrolled_list");
+  std::printf("bytes kept once empty: ring_buffer %zu, unrolled_list ~%zu\n",
+              ring.capacity() * sizeof(int),
+              chunks.allocated_chunks() * 4096);
+}
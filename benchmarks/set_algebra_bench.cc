@@ -0,0 +1,38 @@
+#include <vector>
+
+#include "../lace_set.h"
+#include "../lace_parallel.h"
+#include "bench.h"
+
+namespace {
+
+constexpr int kKeys = 1 << 21;
+
+lace::set<int> every(int step) {
+  std::vector<int> keys;
+  for (int i = 0; i < kKeys * 2; i += step) keys.push_back(i);
+  return lace::set<int>::from_sorted(std::move(keys));
+}
+
+}  // namespace
+
+int main() {
+  auto a = every(2);
+  auto b = every(3);
+  double ops = double(a.size() + b.size());
+
+  double elapsed = bench::seconds([&] {
+    lace::set<int> result;
+    for (int key : a) {
+      if (b.contains(key)) result.insert(key);
+    }
+  });
+  bench::report("intersection by find + insert", 1, ops, elapsed);
+
+  for (unsigned threads : bench::thread_counts()) {
+    elapsed = bench::seconds([&] { lace::set_intersection(a, b, threads); });
+    bench::report("lace::set_intersection", threads, ops, elapsed);
+    elapsed = bench::seconds([&] { lace::set_union(a, b, threads); });
+    bench::report("lace::set_union", threads, ops, elapsed);
+  }
+}
@@ -0,0 +1,62 @@
+#include <mutex>
+#include <random>
+
+#include "../lace_map.h"
+#include "../lace_sharded_map.h"
+#include "bench.h"
+
+namespace {
+
+constexpr int kKeys = 1 << 16;
+constexpr int kOpsPerThread = 1 << 18;
+
+// 90% lookups, 10% insert_or_assign over a pre-filled key space.
+template <typename Lookup, typename Write>
+void mixed_workload(unsigned thread, Lookup lookup, Write write) {
+  std::mt19937 gen(thread);
+  std::uniform_int_distribution<int> key(0, kKeys - 1);
+  for (int i = 0; i < kOpsPerThread; ++i) {
+    if (i % 10 == 0) {
+      write(key(gen), i);
+    } else {
+      lookup(key(gen));
+    }
+  }
+}
+
+}  // namespace
+
+int main() {
+  for (unsigned threads : bench::thread_counts()) {
+    lace::map<int, int> single;
+    std::mutex mutex;
+    for (int i = 0; i < kKeys; ++i) single.insert(i, i);
+    double elapsed = bench::run_threads(threads, [&](unsigned t) {
+      mixed_workload(
+          t,
+          [&](int k) {
+            std::lock_guard<std::mutex> lock(mutex);
+            return single.contains(k);
+          },
+          [&](int k, int v) {
+            std::lock_guard<std::mutex> lock(mutex);
+            single.insert_or_assign(k, v);
+          });
+    });
+    bench::report("mutex + lace::map", threads,
+                  double(threads) * kOpsPerThread, elapsed);
+  }
+
+  for (unsigned threads : bench::thread_counts()) {
+    lace::sharded_map<int, int, 64> sharded;
+    for (int i = 0; i < kKeys; ++i) sharded.insert(i, i);
+    double elapsed = bench::run_threads(threads, [&](unsigned t) {
+      mixed_workload(
+          t, [&](int k) { return sharded.contains(k); },
+          [&](int k, int v) { sharded.insert_or_assign(k, v); });
+    });
+    bench::report("lace::sharded_map<64>", threads,
+                  double(threads) * kOpsPerThread, elapsed);
+  }
+  return 0;
+}
@@ -0,0 +1,100 @@
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "../lace_shm_queue.h"
+#include "bench.h"
+
+namespace {
+
+constexpr int kMessages = 1 << 21;
+
+struct message {
+  long sequence;
+  char payload[56];
+};
+
+// Times a child process producing kMessages with produce() while this
+// process consumes them with consume().
+template <typename Produce, typename Consume>
+double two_processes(Produce produce, Consume consume) {
+  return bench::seconds([&] {
+    pid_t child = ::fork();
+    if (child == 0) {
+      produce();
+      ::_exit(0);
+    }
+    consume();
+    ::waitpid(child, nullptr, 0);
+  });
+}
+
+template <typename Queue>
+double run_queue(const char* tag, long& sum) {
+  std::string name = "/lace_bench_" + std::string(tag) + "_" +
+                     std::to_string(::getpid());
+  auto consumer = Queue::create(name, 1024);
+  auto producer = Queue::open(name);
+  Queue::unlink(name);
+  return two_processes(
+      [&] {
+        message m{};
+        for (long i = 0; i < kMessages; ++i) {
+          m.sequence = i;
+          producer.push(m);
+        }
+      },
+      [&] {
+        message m;
+        for (int i = 0; i < kMessages; ++i) {
+          consumer.pop(m);
+          sum += m.sequence;
+        }
+      });
+}
+
+double run_socket(long& sum) {
+  int fds[2];
+  if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) return 0;
+  double elapsed = two_processes(
+      [&] {
+        message m{};
+        for (long i = 0; i < kMessages; ++i) {
+          m.sequence = i;
+          if (::write(fds[0], &m, sizeof(m)) != sizeof(m)) ::_exit(1);
+        }
+      },
+      [&] {
+        message m;
+        for (int i = 0; i < kMessages; ++i) {
+          size_t got = 0;
+          while (got < sizeof(m)) {
+            ssize_t n = ::read(fds[1], reinterpret_cast<char*>(&m) + got,
+                               sizeof(m) - got);
+            if (n <= 0) return;
+            got += static_cast<size_t>(n);
+          }
+          sum += m.sequence;
+        }
+      });
+  ::close(fds[0]);
+  ::close(fds[1]);
+  return elapsed;
+}
+
+}  // namespace
+
+int main() {
+  volatile long sink = 0;
+  long sum = 0;
+  double elapsed = run_socket(sum);
+  bench::report("unix socketpair", 2, kMessages, elapsed);
+  elapsed = run_queue<lace::shm_queue<message>>("spsc", sum);
+  bench::report("lace::shm_queue", 2, kMessages, elapsed);
+  elapsed = run_queue<lace::shm_mpsc_queue<message>>("mpsc", sum);
+  bench::report("lace::shm_mpsc_queue", 2, kMessages, elapsed);
+  sink = sum;
+  (void)sink;
+}
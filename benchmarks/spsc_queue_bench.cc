@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../lace_queue.h"
+#include "../lace_spsc_queue.h"
+#include "bench.h"
+
+namespace {
+
+constexpr int kMessages = 1 << 22;
+constexpr size_t kBatch = 32;
+
+// Runs produce() and consume() on their own threads; both return once
+// kMessages have gone through.
+template <typename Produce, typename Consume>
+double hand_over(Produce produce, Consume consume) {
+  return bench::seconds([&] {
+    std::thread producer(produce);
+    consume();
+    producer.join();
+  });
+}
+
+}  // namespace
+
+int main() {
+  {
+    lace::queue<int> q;
+    std::mutex mutex;
+    double elapsed = hand_over(
+        [&] {
+          for (int i = 0; i < kMessages; ++i) {
+            std::lock_guard<std::mutex> lock(mutex);
+            q.push(i);
+          }
+        },
+        [&] {
+          for (int received = 0; received < kMessages;) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!q.empty()) {
+              q.pop();
+              ++received;
+            }
+          }
+        });
+    bench::report("mutex + lace::queue", 2, kMessages, elapsed);
+  }
+
+  {
+    lace::spsc_queue<int> q(1024);
+    double elapsed = hand_over(
+        [&] {
+          for (int i = 0; i < kMessages;) {
+            if (q.try_push(i)) {
+              ++i;
+            } else {
+              std::this_thread::yield();
+            }
+          }
+        },
+        [&] {
+          int value;
+          for (int received = 0; received < kMessages;) {
+            if (q.try_pop(value)) {
+              ++received;
+            } else {
+              std::this_thread::yield();
+            }
+          }
+        });
+    bench::report("lace::spsc_queue try_push/try_pop", 2, kMessages,
+                  elapsed);
+  }
+
+  {
+    lace::spsc_queue<int> q(1024);
+    double elapsed = hand_over(
+        [&] {
+          std::vector<int> batch(kBatch);
+          for (int i = 0; i < kMessages;) {
+            size_t n = std::min<size_t>(kBatch, kMessages - i);
+            for (size_t j = 0; j < n; ++j) batch[j] = i + int(j);
+            size_t pushed = q.push_n(batch.begin(), n);
+            if (pushed == 0) std::this_thread::yield();
+            i += int(pushed);
+          }
+        },
+        [&] {
+          std::vector<int> batch(kBatch);
+          for (int received = 0; received < kMessages;) {
+            size_t popped = q.pop_n(batch.begin(), kBatch);
+            if (popped == 0) std::this_thread::yield();
+            received += int(popped);
+          }
+        });
+    bench::report("lace::spsc_queue push_n/pop_n (32)", 2, kMessages,
+                  elapsed);
+  }
+}
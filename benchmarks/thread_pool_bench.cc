@@ -0,0 +1,53 @@
+#include <future>
+
+#include "../lace_thread_pool.h"
+#include "bench.h"
+
+namespace {
+
+constexpr int kDepth = 32;
+
+long fib(int n) { return n < 2 ? n : fib(n - 1) + fib(n - 2); }
+
+// Forks every call down to n == cutoff.
+long pool_fib(lace::thread_pool& pool, int n, int cutoff) {
+  if (n <= cutoff) return fib(n);
+  long left = 0;
+  lace::task_group group(pool);
+  group.run([&] { left = pool_fib(pool, n - 1, cutoff); });
+  long right = pool_fib(pool, n - 2, cutoff);
+  group.wait();
+  return left + right;
+}
+
+long async_fib(int n, int cutoff) {
+  if (n <= cutoff) return fib(n);
+  auto left = std::async(std::launch::async, async_fib, n - 1, cutoff);
+  long right = async_fib(n - 2, cutoff);
+  return left.get() + right;
+}
+
+// Calls made by the naive recursion, i.e. the work measured.
+double calls(int n) { return 2.0 * static_cast<double>(fib(n + 1)) - 1; }
+
+}  // namespace
+
+int main() {
+  volatile long sink = 0;
+  double elapsed = bench::seconds([&] { sink = fib(kDepth); });
+  bench::report("sequential", 1, calls(kDepth), elapsed);
+
+  for (unsigned threads : bench::thread_counts()) {
+    lace::thread_pool pool(threads);
+    elapsed = bench::seconds([&] { sink = pool_fib(pool, kDepth, 20); });
+    bench::report("lace::thread_pool fork at n > 20", threads, calls(kDepth),
+                  elapsed);
+    elapsed = bench::seconds([&] { sink = pool_fib(pool, kDepth, 10); });
+    bench::report("lace::thread_pool fork at n > 10", threads, calls(kDepth),
+                  elapsed);
+  }
+  elapsed = bench::seconds([&] { sink = async_fib(kDepth, 20); });
+  bench::report("std::async fork at n > 20", bench::max_threads(),
+                calls(kDepth), elapsed);
+  (void)sink;
+}
@@ -0,0 +1,161 @@
+#ifndef _LACE_BLOCKING_QUEUE_H_
+#define _LACE_BLOCKING_QUEUE_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+#include <utility>
+
+#include "lace_queue.h"
+
+namespace lace {
+
+// FIFO hand-off between threads: a lace::queue behind one mutex, with
+// condition variables for "not empty" and "not full". A bounded queue makes
+// producers wait while it holds capacity() items.
+//
+// close() wakes every waiter. Pushes to a closed queue fail, and pops keep
+// returning the remaining items and fail once the queue is empty, so
+// consumers drain whatever was pushed before close().
+template <typename T>
+class blocking_queue {
+ public:
+  using value_type = T;
+  using size_type = size_t;
+
+  static constexpr size_type kUnbounded = std::numeric_limits<size_type>::max();
+
+  explicit blocking_queue(size_type capacity = kUnbounded)
+      : capacity_(capacity == 0 ? 1 : capacity) {}
+
+  blocking_queue(const blocking_queue&) = delete;
+  blocking_queue& operator=(const blocking_queue&) = delete;
+
+  // Waits for room. Returns false, leaving value alone, if the queue is
+  // closed.
+  bool push(const value_type& value) { return emplace(true, value); }
+  bool push(value_type&& value) { return emplace(true, std::move(value)); }
+
+  // Returns false instead of waiting when the queue is full.
+  bool try_push(const value_type& value) { return emplace(false, value); }
+  bool try_push(value_type&& value) {
+    return emplace(false, std::move(value));
+  }
+
+  // Waits for an item. Returns false once the queue is closed and empty.
+  bool pop(value_type& out) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    wait_for_items(lock);
+    return take(lock, out);
+  }
+
+  bool try_pop(value_type& out) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return take(lock, out);
+  }
+
+  // Like pop, but also returns false if nothing arrives within timeout.
+  template <typename Rep, typename Period>
+  bool pop_for(value_type& out,
+               const std::chrono::duration<Rep, Period>& timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    pop_waiters_++;
+    not_empty_.wait_for(lock, timeout,
+                        [this] { return !items_.empty() || closed_; });
+    pop_waiters_--;
+    return take(lock, out);
+  }
+
+  // Waits for at least one item, then moves up to max_n items to out under
+  // the same lock. Returns how many were moved: between 1 and max_n, or 0
+  // once the queue is closed and empty. With max_n == 0 it returns 0 at once
+  // without waiting.
+  template <typename OutputIt>
+  size_type drain(OutputIt out, size_type max_n) {
+    if (max_n == 0) return 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    wait_for_items(lock);
+    size_type count = 0;
+    for (; count < max_n && !items_.empty(); ++count, ++out) {
+      *out = std::move(items_.front());
+      items_.pop();
+    }
+    bool wake = push_waiters_ > 0;
+    lock.unlock();
+    if (wake && count > 1) {
+      not_full_.notify_all();
+    } else if (wake && count == 1) {
+      not_full_.notify_one();
+    }
+    return count;
+  }
+
+  void close() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      closed_ = true;
+    }
+    not_empty_.notify_all();
+    not_full_.notify_all();
+  }
+
+  bool closed() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return closed_;
+  }
+
+  size_type size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return items_.size();
+  }
+  bool empty() const { return size() == 0; }
+  size_type capacity() const { return capacity_; }
+
+ private:
+  mutable std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+  queue<value_type> items_;
+  const size_type capacity_;
+  bool closed_ = false;
+  // Threads blocked on each condition; nobody is notified when it is zero.
+  size_type pop_waiters_ = 0;
+  size_type push_waiters_ = 0;
+
+  void wait_for_items(std::unique_lock<std::mutex>& lock) {
+    pop_waiters_++;
+    not_empty_.wait(lock, [this] { return !items_.empty() || closed_; });
+    pop_waiters_--;
+  }
+
+  template <typename U>
+  bool emplace(bool wait, U&& value) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (wait) {
+      push_waiters_++;
+      not_full_.wait(lock,
+                     [this] { return items_.size() < capacity_ || closed_; });
+      push_waiters_--;
+    }
+    if (closed_ || items_.size() >= capacity_) return false;
+    items_.push(std::forward<U>(value));
+    bool wake = pop_waiters_ > 0;
+    lock.unlock();
+    if (wake) not_empty_.notify_one();
+    return true;
+  }
+
+  // Pops the front item if there is one, then releases the lock.
+  bool take(std::unique_lock<std::mutex>& lock, value_type& out) {
+    if (items_.empty()) return false;
+    out = std::move(items_.front());
+    items_.pop();
+    bool wake = push_waiters_ > 0;
+    lock.unlock();
+    if (wake) not_full_.notify_one();
+    return true;
+  }
+};  // blocking_queue
+}  // namespace lace
+#endif  // _LACE_BLOCKING_QUEUE_H_
@@ -0,0 +1,305 @@
+#ifndef _LACE_CHANNEL_H_
+#define _LACE_CHANNEL_H_
+
+// Needs C++20 coroutines; the header is empty in earlier modes.
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#include <coroutine>
+#include <exception>
+#include <limits>
+#include <optional>
+#include <utility>
+
+#include "lace_ring_buffer.h"
+
+namespace lace {
+
+class executor;
+
+// Coroutine started with executor::spawn. It runs until its first
+// suspension when the executor gets to it and frees itself when it
+// finishes. An exception escaping the coroutine terminates the program.
+class job {
+ public:
+  struct promise_type {
+    executor* owner = nullptr;
+    promise_type* prev = nullptr;
+    promise_type* next = nullptr;
+
+    job get_return_object() {
+      return job(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() { std::terminate(); }
+    ~promise_type();
+  };
+
+  job(job&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+  job& operator=(job&&) = delete;
+
+  // A job that was never spawned is destroyed with its handle.
+  ~job() {
+    if (handle_) handle_.destroy();
+  }
+
+ private:
+  friend class executor;
+
+  std::coroutine_handle<promise_type> handle_;
+
+  explicit job(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+};
+
+// Single-threaded run loop: resumes ready coroutines one after another on
+// the thread that calls run(). Channels hand woken waiters to post(), so a
+// wake-up is a push onto a ring buffer rather than a thread switch.
+//
+// Jobs still suspended when the executor is destroyed are destroyed with
+// it.
+class executor {
+ public:
+  executor() = default;
+  executor(const executor&) = delete;
+  executor& operator=(const executor&) = delete;
+
+  ~executor() {
+    ready_.clear();
+    while (live_ != nullptr) {
+      std::coroutine_handle<job::promise_type>::from_promise(*live_)
+          .destroy();
+    }
+  }
+
+  void spawn(job j) {
+    auto handle = std::exchange(j.handle_, {});
+    job::promise_type& promise = handle.promise();
+    promise.owner = this;
+    promise.next = live_;
+    if (live_ != nullptr) live_->prev = &promise;
+    live_ = &promise;
+    post(handle);
+  }
+
+  void post(std::coroutine_handle<> handle) { ready_.push_back(handle); }
+
+  // Resumes the oldest ready coroutine. Returns false if none is ready.
+  bool run_one() {
+    if (ready_.empty()) return false;
+    std::coroutine_handle<> handle = ready_.front();
+    ready_.pop_front();
+    handle.resume();
+    return true;
+  }
+
+  // Runs until no coroutine is ready, i.e. every job has finished or waits
+  // on something only another thread could provide. Returns how many
+  // resumptions it made.
+  size_t run() {
+    size_t resumed = 0;
+    while (run_one()) ++resumed;
+    return resumed;
+  }
+
+  // Jobs spawned and not yet finished.
+  bool idle() const { return live_ == nullptr; }
+
+ private:
+  friend struct job::promise_type;
+
+  ring_buffer<std::coroutine_handle<>> ready_;
+  job::promise_type* live_ = nullptr;
+
+  void forget(job::promise_type* promise) {
+    if (promise->prev != nullptr) {
+      promise->prev->next = promise->next;
+    } else {
+      live_ = promise->next;
+    }
+    if (promise->next != nullptr) promise->next->prev = promise->prev;
+  }
+};
+
+inline job::promise_type::~promise_type() {
+  if (owner != nullptr) owner->forget(this);
+}
+
+// FIFO channel between coroutines on one executor. co_await send(v) waits
+// while a bounded channel is full and yields false if the channel is
+// closed; co_await recv() waits for a value and yields std::nullopt once
+// the channel is closed and drained. Capacity 0 makes every send wait for a
+// receiver.
+//
+// Waiting coroutines are queued through their awaiters, which live in the
+// coroutine frames, and a value sent to a waiting receiver is moved
+// straight into its awaiter. Once the buffer has grown to its working size,
+// passing a message allocates nothing.
+//
+// Not thread-safe: every coroutine using a channel must run on its
+// executor.
+template <typename T>
+class channel {
+ public:
+  using value_type = T;
+  using size_type = size_t;
+
+  static constexpr size_type kUnbounded = std::numeric_limits<size_type>::max();
+
+  class send_awaiter;
+  class recv_awaiter;
+
+  explicit channel(executor& ex, size_type capacity = kUnbounded)
+      : executor_(ex), capacity_(capacity) {}
+
+  channel(const channel&) = delete;
+  channel& operator=(const channel&) = delete;
+
+  send_awaiter send(value_type value) {
+    return send_awaiter(*this, std::move(value));
+  }
+  recv_awaiter recv() { return recv_awaiter(*this); }
+
+  // Returns false, leaving value alone, if the channel is closed or a send
+  // would have to wait.
+  template <typename U>
+  bool try_send(U&& value) {
+    return !closed_ && offer(std::forward<U>(value));
+  }
+
+  std::optional<value_type> try_recv() {
+    std::optional<value_type> out;
+    take(out);
+    return out;
+  }
+
+  // Wakes every waiter: pending sends yield false and, once the buffered
+  // values are gone, receives yield std::nullopt.
+  void close() {
+    closed_ = true;
+    while (recv_awaiter* r = receivers_.pop()) executor_.post(r->handle_);
+    while (send_awaiter* s = senders_.pop()) {
+      s->ok_ = false;
+      executor_.post(s->handle_);
+    }
+  }
+
+  bool closed() const { return closed_; }
+  size_type size() const { return buffer_.size(); }
+  bool empty() const { return buffer_.empty(); }
+  size_type capacity() const { return capacity_; }
+
+  class send_awaiter {
+   public:
+    bool await_ready() {
+      ok_ = !channel_.closed_ && channel_.offer(std::move(value_));
+      return ok_ || channel_.closed_;
+    }
+    void await_suspend(std::coroutine_handle<> handle) {
+      handle_ = handle;
+      channel_.senders_.push(this);
+    }
+    bool await_resume() { return ok_; }
+
+   private:
+    friend class channel;
+
+    channel& channel_;
+    value_type value_;
+    bool ok_ = false;
+    std::coroutine_handle<> handle_;
+    send_awaiter* next_ = nullptr;
+
+    send_awaiter(channel& ch, value_type value)
+        : channel_(ch), value_(std::move(value)) {}
+  };
+
+  class recv_awaiter {
+   public:
+    bool await_ready() { return channel_.take(value_) || channel_.closed_; }
+    void await_suspend(std::coroutine_handle<> handle) {
+      handle_ = handle;
+      channel_.receivers_.push(this);
+    }
+    std::optional<value_type> await_resume() { return std::move(value_); }
+
+   private:
+    friend class channel;
+
+    channel& channel_;
+    std::optional<value_type> value_;
+    std::coroutine_handle<> handle_;
+    recv_awaiter* next_ = nullptr;
+
+    explicit recv_awaiter(channel& ch) : channel_(ch) {}
+  };
+
+ private:
+  // Intrusive FIFO of suspended awaiters.
+  template <typename Waiter>
+  struct waiter_list {
+    Waiter* head = nullptr;
+    Waiter* tail = nullptr;
+
+    void push(Waiter* w) {
+      w->next_ = nullptr;
+      (tail != nullptr ? tail->next_ : head) = w;
+      tail = w;
+    }
+    Waiter* pop() {
+      Waiter* w = head;
+      if (w != nullptr) {
+        head = w->next_;
+        if (head == nullptr) tail = nullptr;
+      }
+      return w;
+    }
+  };
+
+  executor& executor_;
+  const size_type capacity_;
+  ring_buffer<value_type> buffer_;
+  // Receivers only wait while the buffer is empty, senders only while it is
+  // full.
+  waiter_list<recv_awaiter> receivers_;
+  waiter_list<send_awaiter> senders_;
+  bool closed_ = false;
+
+  // Hands value to a waiting receiver or buffers it. Returns false, leaving
+  // value alone, if neither is possible.
+  template <typename U>
+  bool offer(U&& value) {
+    if (recv_awaiter* r = receivers_.pop()) {
+      r->value_.emplace(std::forward<U>(value));
+      executor_.post(r->handle_);
+      return true;
+    }
+    if (buffer_.size() >= capacity_) return false;
+    buffer_.push_back(std::forward<U>(value));
+    return true;
+  }
+
+  // Moves the next value into out, refilling the buffer from the first
+  // waiting sender. Returns false if there is none.
+  bool take(std::optional<value_type>& out) {
+    send_awaiter* s = senders_.pop();
+    if (!buffer_.empty()) {
+      out.emplace(std::move(buffer_.front()));
+      buffer_.pop_front();
+      if (s != nullptr) buffer_.push_back(std::move(s->value_));
+    } else if (s != nullptr) {
+      out.emplace(std::move(s->value_));
+    } else {
+      return false;
+    }
+    if (s != nullptr) {
+      s->ok_ = true;
+      executor_.post(s->handle_);
+    }
+    return true;
+  }
+};  // channel
+}  // namespace lace
+
+#endif  // __cpp_impl_coroutine
+#endif  // _LACE_CHANNEL_H_
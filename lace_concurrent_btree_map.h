@@ -0,0 +1,694 @@
+#ifndef _LACE_CONCURRENT_BTREE_MAP_H_
+#define _LACE_CONCURRENT_BTREE_MAP_H_
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "lace_epoch.h"
+#include "lace_map.h"
+
+namespace lace {
+
+// Concurrent B+tree with optimistic lock coupling. Every node carries a
+// version word that doubles as its write latch. Readers take no latches:
+// they remember a node's version, read it, and check the version is unchanged
+// before trusting what they read, restarting from the root if it is not.
+// Writers latch only the node they change and, when it has to split, its
+// parent. Full nodes are split on the way down, so a split never propagates
+// upwards.
+//
+// A leaf emptied by erase is unlinked under its parent's latch, together
+// with its neighbour under the same parent: the left neighbour takes over
+// its key range, or, for a first child, the leaf absorbs its right
+// neighbour's entries and that neighbour goes instead. The node that leaves
+// the tree stays latched, so readers holding it restart, and is retired
+// through an epoch domain, as lace::concurrent_skiplist_map does, so they
+// never see freed memory. Inner nodes are not merged, and a parent keeps at
+// least one child.
+//
+// Keys and values are copied out of nodes rather than referenced, so both
+// must be trivially copyable. Iterators hold a copy of one leaf's entries and
+// re-seek from the last key when they run out; they see every entry that was
+// present for the whole scan, in order.
+//
+// All member functions except the destructor are safe to call concurrently.
+template <typename Key, typename T>
+class concurrent_btree_map {
+  static_assert(std::is_trivially_copyable_v<Key> &&
+                    std::is_trivially_copyable_v<T>,
+                "concurrent_btree_map needs trivially copyable keys/values");
+
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<const Key, T>;
+  using size_type = size_t;
+
+  static constexpr int kLeafCapacity = 64;
+  static constexpr int kInnerCapacity = 64;
+
+ private:
+  static constexpr uint64_t kLocked = 2;
+
+  struct node_base {
+    std::atomic<uint64_t> version{0};
+    std::atomic<int> count{0};
+    const bool leaf;
+
+    explicit node_base(bool is_leaf) : leaf(is_leaf) {}
+  };
+
+  struct leaf_node : node_base {
+    std::atomic<Key> keys[kLeafCapacity];
+    std::atomic<T> values[kLeafCapacity];
+    std::atomic<leaf_node*> next{nullptr};
+
+    leaf_node() : node_base(true) {}
+  };
+
+  // children[i] holds the keys in (keys[i - 1], keys[i]].
+  struct inner_node : node_base {
+    std::atomic<Key> keys[kInnerCapacity];
+    std::atomic<node_base*> children[kInnerCapacity + 1];
+
+    inner_node() : node_base(false) {
+      for (auto& child : children) {
+        child.store(nullptr, std::memory_order_relaxed);
+      }
+    }
+  };
+
+ public:
+  class const_iterator {
+   public:
+    const_iterator(const const_iterator& other)
+        : owner_(other.owner_), batch_(other.batch_), pos_(other.pos_) {}
+
+    // Entries have const keys, so the batch is rebuilt rather than assigned.
+    const_iterator& operator=(const const_iterator& other) {
+      if (this != &other) {
+        owner_ = other.owner_;
+        batch_.clear();
+        for (const value_type& kv : other.batch_) batch_.push_back(kv);
+        pos_ = other.pos_;
+      }
+      return *this;
+    }
+
+    const value_type& operator*() const {
+      if (batch_.empty()) {
+        throw std::runtime_error("Dereferencing end iterator");
+      }
+      return batch_[pos_];
+    }
+
+    const value_type* operator->() const {
+      if (batch_.empty()) throw std::runtime_error("Accessing end iterator");
+      return &batch_[pos_];
+    }
+
+    const_iterator& operator++() {
+      if (batch_.empty()) {
+        throw std::runtime_error("Incrementing an end iterator");
+      }
+      if (++pos_ == batch_.size()) {
+        Key last = batch_.back().first;
+        owner_->collect(&last, true, batch_);
+        pos_ = 0;
+      }
+      return *this;
+    }
+
+    const_iterator operator++(int) {
+      const_iterator temp = *this;
+      ++(*this);
+      return temp;
+    }
+
+    bool operator==(const const_iterator& other) const {
+      if (batch_.empty() || other.batch_.empty()) {
+        return batch_.empty() && other.batch_.empty();
+      }
+      const Key& a = batch_[pos_].first;
+      const Key& b = other.batch_[other.pos_].first;
+      return !(a < b) && !(b < a);
+    }
+
+    bool operator!=(const const_iterator& other) const {
+      return !(*this == other);
+    }
+
+   private:
+    friend class concurrent_btree_map;
+
+    explicit const_iterator(const concurrent_btree_map* owner)
+        : owner_(owner), pos_(0) {}
+
+    const concurrent_btree_map* owner_;
+    std::vector<value_type> batch_;
+    size_t pos_;
+  };
+
+  using iterator = const_iterator;
+
+  concurrent_btree_map() : root_(new leaf_node()) {}
+
+  concurrent_btree_map(std::initializer_list<std::pair<Key, T>> init_list)
+      : concurrent_btree_map() {
+    for (const auto& item : init_list) insert(item.first, item.second);
+  }
+
+  concurrent_btree_map(const concurrent_btree_map&) = delete;
+  concurrent_btree_map& operator=(const concurrent_btree_map&) = delete;
+
+  // No other thread may use the map while it is destroyed.
+  ~concurrent_btree_map() { destroy(root_.load()); }
+
+  const_iterator begin() const {
+    const_iterator it(this);
+    collect(nullptr, false, it.batch_);
+    return it;
+  }
+  const_iterator end() const { return const_iterator(this); }
+
+  // Exact when the map is quiescent, approximate under concurrent writes.
+  size_type size() const { return size_.load(std::memory_order_relaxed); }
+  bool empty() const { return size() == 0; }
+
+  bool insert(const Key& key, const T& value) {
+    return upsert(key, value, false);
+  }
+  bool insert(const std::pair<Key, T>& pair) {
+    return upsert(pair.first, pair.second, false);
+  }
+
+  // Returns true if the key was inserted, false if its value was replaced.
+  bool insert_or_assign(const Key& key, const T& value) {
+    return upsert(key, value, true);
+  }
+
+  bool erase(const Key& key) {
+    auto guard = domain_.pin();
+    while (true) {
+      uint64_t version;
+      leaf_node* leaf = find_leaf(&key, version);
+      if (leaf == nullptr) continue;
+      int count = leaf_count(leaf);
+      int pos = leaf_lower_bound(leaf, count, key);
+      bool found = holds(leaf, count, pos, key);
+      if (!found) {
+        if (validate(leaf, version)) return false;
+        continue;
+      }
+      if (!upgrade(leaf, version)) continue;
+      for (int i = pos; i + 1 < count; ++i) {
+        move_entry(leaf, i + 1, leaf, i);
+      }
+      leaf->count.store(count - 1, std::memory_order_relaxed);
+      unlock(leaf);
+      size_.fetch_sub(1, std::memory_order_relaxed);
+      if (count == 1) {
+        while (try_unlink_empty(key) < 0) {
+        }
+      }
+      return true;
+    }
+  }
+
+  bool contains(const Key& key) const { return get(key).has_value(); }
+
+  // Returns a copy of the value, or nothing if the key is absent.
+  std::optional<T> get(const Key& key) const {
+    auto guard = domain_.pin();
+    while (true) {
+      uint64_t version;
+      leaf_node* leaf = find_leaf(&key, version);
+      if (leaf == nullptr) continue;
+      int count = leaf_count(leaf);
+      int pos = leaf_lower_bound(leaf, count, key);
+      std::optional<T> result;
+      if (holds(leaf, count, pos, key)) {
+        result = leaf->values[pos].load(std::memory_order_relaxed);
+      }
+      if (validate(leaf, version)) return result;
+    }
+  }
+
+  T at(const Key& key) const {
+    std::optional<T> value = get(key);
+    if (!value) throw std::out_of_range("Key not found");
+    return *value;
+  }
+
+  const_iterator find(const Key& key) const {
+    const_iterator it = lower_bound(key);
+    if (it != end() && key < it->first) return end();
+    return it;
+  }
+
+  const_iterator lower_bound(const Key& key) const {
+    const_iterator it(this);
+    collect(&key, false, it.batch_);
+    return it;
+  }
+
+  const_iterator upper_bound(const Key& key) const {
+    const_iterator it(this);
+    collect(&key, true, it.batch_);
+    return it;
+  }
+
+  // Calls fn(const value_type&) for every key in [lo, hi), in order, on
+  // copies taken leaf by leaf; fn may return false to stop early.
+  template <typename Fn>
+  void for_each_in_range(const Key& lo, const Key& hi, Fn fn) const {
+    std::vector<value_type> batch;
+    collect(&lo, false, batch);
+    while (!batch.empty()) {
+      for (const value_type& kv : batch) {
+        if (!(kv.first < hi) || !detail::call_visitor(fn, kv)) return;
+      }
+      Key last = batch.back().first;
+      collect(&last, true, batch);
+    }
+  }
+
+  // Height of the tree; a lone leaf has depth 1.
+  size_type depth() const {
+    auto guard = domain_.pin();
+    size_type levels = 1;
+    for (const node_base* node = root_.load(); !node->leaf; ++levels) {
+      node = static_cast<const inner_node*>(node)->children[0].load();
+    }
+    return levels;
+  }
+
+  // Leaves in the leaf chain, empty ones included. Exact when the map is
+  // quiescent.
+  size_type leaves() const {
+    auto guard = domain_.pin();
+    node_base* node = root_.load();
+    while (!node->leaf) {
+      node = static_cast<inner_node*>(node)->children[0].load();
+    }
+    size_type count = 0;
+    for (auto* leaf = static_cast<leaf_node*>(node); leaf != nullptr;
+         leaf = leaf->next.load()) {
+      ++count;
+    }
+    return count;
+  }
+
+ private:
+  std::atomic<node_base*> root_;
+  alignas(64) std::atomic<size_type> size_{0};
+  mutable epoch domain_;
+
+  // Counts read without a latch may be torn by a concurrent writer; they are
+  // clamped so that the read stays in bounds until validation rejects it.
+  static int clamp(int count, int capacity) {
+    return count < 0 ? 0 : (count > capacity ? capacity : count);
+  }
+  static int leaf_count(const leaf_node* leaf) {
+    return clamp(leaf->count.load(std::memory_order_relaxed), kLeafCapacity);
+  }
+  static int inner_count(const inner_node* inner) {
+    return clamp(inner->count.load(std::memory_order_relaxed), kInnerCapacity);
+  }
+
+  static bool holds(const leaf_node* leaf, int count, int pos,
+                    const Key& key) {
+    return pos < count &&
+           !(key < leaf->keys[pos].load(std::memory_order_relaxed));
+  }
+
+  // A read may only be trusted if the node was unlocked when it started and
+  // its version has not moved since.
+  static bool read_lock(const node_base* node, uint64_t& version) {
+    version = node->version.load(std::memory_order_acquire);
+    if (version & kLocked) {
+      std::this_thread::yield();
+      return false;
+    }
+    return true;
+  }
+
+  static bool validate(const node_base* node, uint64_t version) {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return node->version.load(std::memory_order_relaxed) == version;
+  }
+
+  // The release fence keeps the writer's stores behind the latch, so a
+  // reader that sees any of them also sees the version change.
+  static bool upgrade(node_base* node, uint64_t version) {
+    if (!node->version.compare_exchange_strong(version, version + kLocked,
+                                               std::memory_order_acquire)) {
+      return false;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    return true;
+  }
+
+  static void unlock(node_base* node) {
+    node->version.fetch_add(kLocked, std::memory_order_release);
+  }
+
+  static int leaf_lower_bound(const leaf_node* leaf, int count,
+                              const Key& key) {
+    int lo = 0;
+    int hi = count;
+    while (lo < hi) {
+      int mid = (lo + hi) / 2;
+      if (leaf->keys[mid].load(std::memory_order_relaxed) < key) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo;
+  }
+
+  static int inner_lower_bound(const inner_node* inner, int count,
+                               const Key& key) {
+    int lo = 0;
+    int hi = count;
+    while (lo < hi) {
+      int mid = (lo + hi) / 2;
+      if (inner->keys[mid].load(std::memory_order_relaxed) < key) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo;
+  }
+
+  // Descends to the leaf that owns key (the leftmost leaf for a null key).
+  // Returns the leaf with the version it was read at, or nullptr to restart.
+  leaf_node* find_leaf(const Key* key, uint64_t& version) const {
+    node_base* node = root_.load(std::memory_order_acquire);
+    if (!read_lock(node, version) || node != root_.load()) return nullptr;
+    while (!node->leaf) {
+      auto* inner = static_cast<inner_node*>(node);
+      int pos = 0;
+      if (key != nullptr) {
+        int count = inner_count(inner);
+        pos = inner_lower_bound(inner, count, *key);
+      }
+      node_base* child = inner->children[pos].load(std::memory_order_relaxed);
+      if (!validate(inner, version)) return nullptr;
+      uint64_t child_version;
+      if (!read_lock(child, child_version)) return nullptr;
+      if (!validate(inner, version)) return nullptr;
+      node = child;
+      version = child_version;
+    }
+    return static_cast<leaf_node*>(node);
+  }
+
+  // Replaces out with the entries of the first leaf that holds a key not
+  // below key (above it when strict), starting from the leftmost leaf when
+  // key is null. Leaves emptied by erases are skipped through the leaf chain.
+  void collect(const Key* key, bool strict,
+               std::vector<value_type>& out) const {
+    auto guard = domain_.pin();
+    while (true) {
+      out.clear();
+      uint64_t version;
+      leaf_node* leaf = find_leaf(key, version);
+      if (leaf == nullptr) continue;
+      bool consistent = true;
+      while (consistent) {
+        int count = leaf_count(leaf);
+        for (int i = 0; i < count; ++i) {
+          Key k = leaf->keys[i].load(std::memory_order_relaxed);
+          if (key != nullptr && (strict ? !(*key < k) : k < *key)) continue;
+          out.emplace_back(k, leaf->values[i].load(std::memory_order_relaxed));
+        }
+        leaf_node* next = leaf->next.load(std::memory_order_relaxed);
+        if (!validate(leaf, version)) {
+          consistent = false;
+        } else if (!out.empty() || next == nullptr) {
+          return;
+        } else {
+          leaf = next;
+          consistent = read_lock(leaf, version);
+        }
+      }
+    }
+  }
+
+  static void move_entry(leaf_node* from, int i, leaf_node* to, int j) {
+    to->keys[j].store(from->keys[i].load(std::memory_order_relaxed),
+                      std::memory_order_relaxed);
+    to->values[j].store(from->values[i].load(std::memory_order_relaxed),
+                        std::memory_order_relaxed);
+  }
+
+  bool upsert(const Key& key, const T& value, bool assign) {
+    auto guard = domain_.pin();
+    while (true) {
+      int result = try_upsert(key, value, assign);
+      if (result >= 0) return result == 1;
+    }
+  }
+
+  // Returns 1 if inserted, 0 if the key was present, -1 to restart.
+  int try_upsert(const Key& key, const T& value, bool assign) {
+    node_base* node = root_.load(std::memory_order_acquire);
+    uint64_t version;
+    if (!read_lock(node, version) || node != root_.load()) return -1;
+    inner_node* parent = nullptr;
+    uint64_t parent_version = 0;
+
+    while (!node->leaf) {
+      auto* inner = static_cast<inner_node*>(node);
+      if (inner->count.load(std::memory_order_relaxed) == kInnerCapacity) {
+        split_and_unlock(parent, parent_version, node, version);
+        return -1;
+      }
+      int count = inner_count(inner);
+      node_base* child =
+          inner->children[inner_lower_bound(inner, count, key)].load(
+              std::memory_order_relaxed);
+      if (!validate(inner, version)) return -1;
+      parent = inner;
+      parent_version = version;
+      node = child;
+      // The child may have been split between reading the pointer and its
+      // version; only the parent's version tells.
+      if (!read_lock(node, version) || !validate(parent, parent_version)) {
+        return -1;
+      }
+    }
+
+    auto* leaf = static_cast<leaf_node*>(node);
+    int count = leaf_count(leaf);
+    int pos = leaf_lower_bound(leaf, count, key);
+    bool found = holds(leaf, count, pos, key);
+    if (found && !assign) return validate(leaf, version) ? 0 : -1;
+    if (!found && count == kLeafCapacity) {
+      split_and_unlock(parent, parent_version, node, version);
+      return -1;
+    }
+    if (!upgrade(leaf, version)) return -1;
+    if (found) {
+      leaf->values[pos].store(value, std::memory_order_relaxed);
+      unlock(leaf);
+      return 0;
+    }
+    for (int i = count; i > pos; --i) move_entry(leaf, i - 1, leaf, i);
+    leaf->keys[pos].store(key, std::memory_order_relaxed);
+    leaf->values[pos].store(value, std::memory_order_relaxed);
+    leaf->count.store(count + 1, std::memory_order_relaxed);
+    unlock(leaf);
+    size_.fetch_add(1, std::memory_order_relaxed);
+    return 1;
+  }
+
+  // Splits a full node under its parent's latch (or replaces the root). Any
+  // failure to latch just means another writer got there first.
+  void split_and_unlock(inner_node* parent, uint64_t parent_version,
+                        node_base* node, uint64_t version) {
+    if (parent != nullptr && !upgrade(parent, parent_version)) return;
+    if (!upgrade(node, version)) {
+      if (parent != nullptr) unlock(parent);
+      return;
+    }
+    if (parent == nullptr && node != root_.load()) {
+      unlock(node);
+      return;
+    }
+
+    auto [separator, sibling] =
+        node->leaf ? split_leaf(static_cast<leaf_node*>(node))
+                   : split_inner(static_cast<inner_node*>(node));
+    if (parent != nullptr) {
+      insert_child(parent, separator, sibling);
+    } else {
+      auto* root = new inner_node();
+      root->keys[0].store(separator, std::memory_order_relaxed);
+      root->children[0].store(node, std::memory_order_relaxed);
+      root->children[1].store(sibling, std::memory_order_relaxed);
+      root->count.store(1, std::memory_order_relaxed);
+      root_.store(root, std::memory_order_release);
+    }
+    unlock(node);
+    if (parent != nullptr) unlock(parent);
+  }
+
+  // Both splits return the separator and the new right sibling.
+  static std::pair<Key, node_base*> split_leaf(leaf_node* leaf) {
+    auto* sibling = new leaf_node();
+    int count = leaf->count.load(std::memory_order_relaxed);
+    int keep = count / 2;
+    for (int i = keep; i < count; ++i) move_entry(leaf, i, sibling, i - keep);
+    sibling->count.store(count - keep, std::memory_order_relaxed);
+    sibling->next.store(leaf->next.load(std::memory_order_relaxed),
+                        std::memory_order_relaxed);
+    leaf->next.store(sibling, std::memory_order_relaxed);
+    leaf->count.store(keep, std::memory_order_relaxed);
+    return {leaf->keys[keep - 1].load(std::memory_order_relaxed), sibling};
+  }
+
+  static std::pair<Key, node_base*> split_inner(inner_node* inner) {
+    auto* sibling = new inner_node();
+    int count = inner->count.load(std::memory_order_relaxed);
+    int mid = count / 2;
+    for (int i = mid + 1; i < count; ++i) {
+      sibling->keys[i - mid - 1].store(
+          inner->keys[i].load(std::memory_order_relaxed),
+          std::memory_order_relaxed);
+    }
+    for (int i = mid + 1; i <= count; ++i) {
+      sibling->children[i - mid - 1].store(
+          inner->children[i].load(std::memory_order_relaxed),
+          std::memory_order_relaxed);
+    }
+    sibling->count.store(count - mid - 1, std::memory_order_relaxed);
+    inner->count.store(mid, std::memory_order_relaxed);
+    return {inner->keys[mid].load(std::memory_order_relaxed), sibling};
+  }
+
+  static void insert_child(inner_node* inner, const Key& separator,
+                           node_base* child) {
+    int count = inner->count.load(std::memory_order_relaxed);
+    int pos = inner_lower_bound(inner, count, separator);
+    for (int i = count; i > pos; --i) {
+      inner->keys[i].store(inner->keys[i - 1].load(std::memory_order_relaxed),
+                           std::memory_order_relaxed);
+      inner->children[i + 1].store(
+          inner->children[i].load(std::memory_order_relaxed),
+          std::memory_order_relaxed);
+    }
+    inner->keys[pos].store(separator, std::memory_order_relaxed);
+    inner->children[pos + 1].store(child, std::memory_order_relaxed);
+    inner->count.store(count + 1, std::memory_order_relaxed);
+  }
+
+  // Unlinks the leaf that owns key if it is empty and its parent has another
+  // child. Returns 1 if a leaf left the tree, 0 if there was nothing to do
+  // and -1 to restart.
+  int try_unlink_empty(const Key& key) {
+    node_base* node = root_.load(std::memory_order_acquire);
+    uint64_t version;
+    if (!read_lock(node, version) || node != root_.load()) return -1;
+    if (node->leaf) return 0;
+
+    inner_node* parent;
+    uint64_t parent_version;
+    int pos;
+    while (true) {
+      parent = static_cast<inner_node*>(node);
+      parent_version = version;
+      pos = inner_lower_bound(parent, inner_count(parent), key);
+      node = parent->children[pos].load(std::memory_order_relaxed);
+      if (!validate(parent, parent_version)) return -1;
+      if (!read_lock(node, version) || !validate(parent, parent_version)) {
+        return -1;
+      }
+      if (node->leaf) break;
+    }
+
+    auto* leaf = static_cast<leaf_node*>(node);
+    int parent_count = parent->count.load(std::memory_order_relaxed);
+    bool empty = leaf->count.load(std::memory_order_relaxed) == 0;
+    if (!validate(leaf, version) || !validate(parent, parent_version)) {
+      return -1;
+    }
+    if (!empty || parent_count == 0) return 0;
+
+    // The left neighbour, or the right one for a first child.
+    auto* other = static_cast<leaf_node*>(
+        parent->children[pos > 0 ? pos - 1 : 1].load(
+            std::memory_order_relaxed));
+    if (!validate(parent, parent_version)) return -1;
+    uint64_t other_version;
+    if (!read_lock(other, other_version)) return -1;
+    if (!upgrade(parent, parent_version)) return -1;
+    if (!upgrade(leaf, version)) {
+      unlock(parent);
+      return -1;
+    }
+    if (!upgrade(other, other_version)) {
+      unlock(leaf);
+      unlock(parent);
+      return -1;
+    }
+
+    leaf_node* victim;
+    if (pos > 0) {
+      other->next.store(leaf->next.load(std::memory_order_relaxed),
+                        std::memory_order_relaxed);
+      remove_child(parent, pos - 1);
+      unlock(other);
+      victim = leaf;
+    } else {
+      int count = other->count.load(std::memory_order_relaxed);
+      for (int i = 0; i < count; ++i) move_entry(other, i, leaf, i);
+      leaf->count.store(count, std::memory_order_relaxed);
+      leaf->next.store(other->next.load(std::memory_order_relaxed),
+                       std::memory_order_relaxed);
+      remove_child(parent, 0);
+      unlock(leaf);
+      victim = other;
+    }
+    unlock(parent);
+    // The victim is never unlatched: anyone still holding it restarts.
+    domain_.retire(victim);
+    return 1;
+  }
+
+  // Drops keys[pos] and children[pos + 1].
+  static void remove_child(inner_node* inner, int pos) {
+    int count = inner->count.load(std::memory_order_relaxed);
+    for (int i = pos; i + 1 < count; ++i) {
+      inner->keys[i].store(inner->keys[i + 1].load(std::memory_order_relaxed),
+                           std::memory_order_relaxed);
+      inner->children[i + 1].store(
+          inner->children[i + 2].load(std::memory_order_relaxed),
+          std::memory_order_relaxed);
+    }
+    inner->count.store(count - 1, std::memory_order_relaxed);
+  }
+
+  static void destroy(node_base* node) {
+    if (node->leaf) {
+      delete static_cast<leaf_node*>(node);
+      return;
+    }
+    auto* inner = static_cast<inner_node*>(node);
+    int count = inner->count.load(std::memory_order_relaxed);
+    for (int i = 0; i <= count; ++i) destroy(inner->children[i].load());
+    delete inner;
+  }
+
+};  // concurrent_btree_map
+}  // namespace lace
+#endif  // _LACE_CONCURRENT_BTREE_MAP_H_
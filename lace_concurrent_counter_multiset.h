@@ -0,0 +1,136 @@
+#ifndef _LACE_CONCURRENT_COUNTER_MULTISET_H_
+#define _LACE_CONCURRENT_COUNTER_MULTISET_H_
+
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "lace_multiset.h"
+#include "lace_rcu_map.h"
+
+namespace lace {
+
+// Concurrent multiset for counting, e.g. hot-key metrics. Each key owns a
+// block of Stripes counters, each on its own cache line, and a thread always
+// adds to the same stripe, so threads bumping one hot key do not fight over a
+// single line.
+//
+// Keys are indexed by an rcu_map. Adding to a key that is already present is
+// a lock-free lookup plus one relaxed fetch_add; only the first add of a key
+// takes the writer lock to publish its block. Counts read while other threads
+// add are approximate, and an add that races with erase() or clear() of the
+// same key may be lost.
+template <typename Key, size_t Stripes = 8>
+class concurrent_counter_multiset {
+  static_assert(Stripes > 0, "concurrent_counter_multiset needs a stripe");
+
+ public:
+  using key_type = Key;
+  using size_type = size_t;
+
+ private:
+  struct alignas(64) stripe {
+    std::atomic<size_type> value{0};
+  };
+
+  struct cell {
+    stripe stripes[Stripes];
+
+    size_type total() const {
+      size_type sum = 0;
+      for (const stripe& s : stripes) {
+        sum += s.value.load(std::memory_order_relaxed);
+      }
+      return sum;
+    }
+  };
+
+  using cell_ptr = std::shared_ptr<cell>;
+
+ public:
+  concurrent_counter_multiset() = default;
+
+  concurrent_counter_multiset(const concurrent_counter_multiset&) = delete;
+  concurrent_counter_multiset& operator=(const concurrent_counter_multiset&) =
+      delete;
+
+  // Adds count occurrences of key.
+  void insert(const Key& key, size_type count = 1) {
+    if (count == 0) return;
+    {
+      auto version = index_.make_reader().pin();
+      if (const cell_ptr* block = version->lookup(key)) {
+        add(**block, count);
+        return;
+      }
+    }
+    cell_ptr block = std::make_shared<cell>();
+    index_.update([&](auto& next) {
+      if (const cell_ptr* existing = next.lookup(key)) {
+        block = *existing;
+      } else {
+        next.insert(key, block);
+      }
+    });
+    add(*block, count);
+  }
+
+  size_type count(const Key& key) const {
+    auto version = index_.make_reader().pin();
+    const cell_ptr* block = version->lookup(key);
+    return block == nullptr ? 0 : (*block)->total();
+  }
+
+  bool contains(const Key& key) const { return count(key) != 0; }
+
+  // Total number of occurrences; visits every counter.
+  size_type size() const {
+    auto version = index_.make_reader().pin();
+    size_type sum = 0;
+    for (const auto& kv : *version) sum += kv.second->total();
+    return sum;
+  }
+
+  bool empty() const { return size() == 0; }
+
+  // Drops key together with all of its occurrences.
+  bool erase(const Key& key) { return index_.erase(key); }
+
+  void clear() { index_.clear(); }
+
+  // Copies the current counts into an ordinary multiset, built in linear
+  // time from one consistent version of the key index. Any arguments are
+  // passed on to multiset::from_counts.
+  template <typename... BuildArgs>
+  multiset<Key> snapshot(const BuildArgs&... build_args) const {
+    std::vector<std::pair<Key, size_type>> counts;
+    {
+      auto version = index_.make_reader().pin();
+      counts.reserve(version->size());
+      for (const auto& kv : *version) {
+        size_type total = kv.second->total();
+        if (total != 0) counts.emplace_back(kv.first, total);
+      }
+    }
+    return multiset<Key>::from_counts(std::move(counts), build_args...);
+  }
+
+ private:
+  rcu_map<Key, cell_ptr> index_;
+
+  static void add(cell& block, size_type count) {
+    block.stripes[stripe_index()].value.fetch_add(count,
+                                                  std::memory_order_relaxed);
+  }
+
+  static size_t stripe_index() {
+    static std::atomic<size_t> next{0};
+    thread_local size_t index =
+        next.fetch_add(1, std::memory_order_relaxed) % Stripes;
+    return index;
+  }
+
+};  // concurrent_counter_multiset
+}  // namespace lace
+#endif  // _LACE_CONCURRENT_COUNTER_MULTISET_H_
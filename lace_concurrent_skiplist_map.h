@@ -0,0 +1,465 @@
+#ifndef _LACE_CONCURRENT_SKIPLIST_MAP_H_
+#define _LACE_CONCURRENT_SKIPLIST_MAP_H_
+
+#include <atomic>
+#include <cstdint>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "lace_epoch.h"
+
+namespace lace {
+
+// Lock-free ordered map. Every level of the skip list is a Harris linked list:
+// a node is deleted by setting the low bit of its next pointers (top level
+// first, level 0 last, which is the linearisation point) and is then unlinked
+// by whichever thread walks past it.
+//
+// Unlinked nodes are reclaimed through Domain, lace::epoch or
+// lace::hazard_pointer. Walks hold the node they came from, the current node
+// and its successor in domain guards, recheck the link they followed before
+// moving on and restart from the top when it changed, so they never step
+// through a deleted node. Under an epoch the guards are pins and protecting
+// is a plain load. Under hazard pointers a stalled reader holds back only the
+// nodes it stands on; an iterator keeps one hazard slot of its thread and an
+// operation briefly takes up to four more.
+//
+// All member functions except the destructor are safe to call concurrently.
+// Values are immutable once inserted. An iterator protects its node for as
+// long as it exists, so it must stay on the thread that created it and should
+// not be held for long.
+template <typename Key, typename T, typename Domain = epoch>
+class concurrent_skiplist_map {
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<const Key, T>;
+  using size_type = size_t;
+  using domain_type = Domain;
+
+  static constexpr int kMaxHeight = 24;
+
+ private:
+  using link = std::atomic<uintptr_t>;
+  using guard = typename Domain::guard;
+
+  // A node finished by its inserter and a node finished by its deleter are
+  // marked separately; whoever comes second retires it.
+  static constexpr uint8_t kLinked = 1;
+  static constexpr uint8_t kUnlinked = 2;
+
+  struct Node {
+    value_type kv;
+    int height;
+    std::atomic<uint8_t> state{0};
+    link* next;
+
+    Node(const Key& key, const T& value, int h)
+        : kv(std::make_pair(key, value)), height(h), next(nullptr) {}
+  };
+
+  static bool is_marked(uintptr_t bits) { return (bits & 1) != 0; }
+  static Node* to_node(uintptr_t bits) {
+    return reinterpret_cast<Node*>(bits & ~uintptr_t(1));
+  }
+  static uintptr_t to_bits(Node* node) {
+    return reinterpret_cast<uintptr_t>(node);
+  }
+
+  // Guards of one walk. The roles rotate through the three guards as the
+  // walk advances, so a node never has to be copied from one hazard slot to
+  // another, which a concurrent scan could miss.
+  struct cursor {
+    explicit cursor(Domain& domain)
+        : guards{domain.make_guard(), domain.make_guard(),
+                 domain.make_guard()} {}
+
+    guard guards[3];
+    int pred = 0;
+    int curr = 1;
+    int succ = 2;
+    // Where the walk stopped: the links of the last node before the key (or
+    // head_) and the node after it, which guards[curr] protects.
+    link* links = nullptr;
+    Node* node = nullptr;
+  };
+
+ public:
+  class const_iterator {
+   public:
+    const_iterator(const const_iterator& other)
+        : owner_(other.owner_), current_(other.current_) {
+      if (current_ != nullptr) owner_->copy_protection(other, *this);
+    }
+
+    const_iterator(const_iterator&& other) noexcept
+        : owner_(other.owner_),
+          guard_(std::move(other.guard_)),
+          current_(std::exchange(other.current_, nullptr)) {}
+
+    const_iterator& operator=(const const_iterator& other) {
+      if (this != &other) *this = const_iterator(other);
+      return *this;
+    }
+
+    const_iterator& operator=(const_iterator&& other) noexcept {
+      owner_ = other.owner_;
+      guard_ = std::move(other.guard_);
+      current_ = std::exchange(other.current_, nullptr);
+      return *this;
+    }
+
+    const value_type& operator*() const {
+      if (!current_) throw std::runtime_error("Dereferencing end iterator");
+      return current_->kv;
+    }
+
+    const value_type* operator->() const {
+      if (!current_) throw std::runtime_error("Accessing end iterator");
+      return &current_->kv;
+    }
+
+    // Skips nodes deleted after the iterator reached them.
+    const_iterator& operator++() {
+      if (!current_) throw std::runtime_error("Incrementing an end iterator");
+      owner_->advance(*this);
+      return *this;
+    }
+
+    const_iterator operator++(int) {
+      const_iterator temp = *this;
+      ++(*this);
+      return temp;
+    }
+
+    bool operator==(const const_iterator& other) const {
+      return current_ == other.current_;
+    }
+    bool operator!=(const const_iterator& other) const {
+      return current_ != other.current_;
+    }
+
+   private:
+    friend class concurrent_skiplist_map;
+
+    explicit const_iterator(const concurrent_skiplist_map* owner)
+        : owner_(owner), current_(nullptr) {}
+
+    // Takes over the guard that protects the node the walk stopped at.
+    const_iterator(const concurrent_skiplist_map* owner, cursor& c)
+        : owner_(owner), current_(c.node) {
+      if (current_ != nullptr) guard_.emplace(std::move(c.guards[c.curr]));
+    }
+
+    const concurrent_skiplist_map* owner_;
+    std::optional<guard> guard_;
+    Node* current_;
+  };
+
+  using iterator = const_iterator;
+
+  concurrent_skiplist_map() {
+    for (link& l : head_) l.store(0, std::memory_order_relaxed);
+  }
+
+  concurrent_skiplist_map(std::initializer_list<std::pair<Key, T>> init_list)
+      : concurrent_skiplist_map() {
+    for (const auto& item : init_list) insert(item.first, item.second);
+  }
+
+  concurrent_skiplist_map(const concurrent_skiplist_map&) = delete;
+  concurrent_skiplist_map& operator=(const concurrent_skiplist_map&) = delete;
+
+  // No other thread may use the map while it is destroyed.
+  ~concurrent_skiplist_map() {
+    Node* node = to_node(head_[0].load());
+    while (node != nullptr) {
+      Node* next = to_node(node->next[0].load());
+      destroy_node(node);
+      node = next;
+    }
+  }
+
+  const_iterator begin() const {
+    cursor c(domain_);
+    descend(nullptr, false, 0, c);
+    return const_iterator(this, c);
+  }
+  const_iterator end() const { return const_iterator(this); }
+
+  // Exact when the map is quiescent, approximate under concurrent writes.
+  size_type size() const { return size_.load(std::memory_order_relaxed); }
+  bool empty() const { return size() == 0; }
+
+  bool insert(const Key& key, const T& value) {
+    cursor c(domain_);
+    int height = random_height();
+    raise_height(height);
+    Node* node = nullptr;
+    while (true) {
+      descend(&key, false, 0, c);
+      if (c.node != nullptr && !(key < c.node->kv.first)) {
+        if (node != nullptr) destroy_node(node);
+        return false;
+      }
+      if (node == nullptr) node = create_node(key, value, height);
+      node->next[0].store(to_bits(c.node), std::memory_order_relaxed);
+      uintptr_t expected = to_bits(c.node);
+      if (c.links[0].compare_exchange_strong(expected, to_bits(node))) break;
+    }
+    size_.fetch_add(1, std::memory_order_relaxed);
+    link_upper_levels(node, c);
+    if (is_marked(node->next[0].load())) descend(&key, true, 0, c);
+    if (node->state.fetch_or(kLinked) & kUnlinked) retire(node);
+    return true;
+  }
+
+  bool insert(const std::pair<Key, T>& pair) {
+    return insert(pair.first, pair.second);
+  }
+
+  bool erase(const Key& key) {
+    cursor c(domain_);
+    descend(&key, false, 0, c);
+    Node* victim = c.node;
+    if (victim == nullptr || key < victim->kv.first) return false;
+    // Keeps the victim's slot out of the walk below that unlinks it.
+    guard hold = domain_.make_guard();
+    std::swap(hold, c.guards[c.curr]);
+    for (int level = victim->height - 1; level > 0; --level) {
+      uintptr_t bits = victim->next[level].load();
+      while (!is_marked(bits) &&
+             !victim->next[level].compare_exchange_weak(bits, bits | 1)) {
+      }
+    }
+    uintptr_t bits = victim->next[0].load();
+    while (true) {
+      if (is_marked(bits)) return false;
+      if (victim->next[0].compare_exchange_weak(bits, bits | 1)) break;
+    }
+    size_.fetch_sub(1, std::memory_order_relaxed);
+    descend(&key, true, 0, c);
+    if (victim->state.fetch_or(kUnlinked) & kLinked) retire(victim);
+    return true;
+  }
+
+  // Removes the keys one at a time; concurrent inserts may survive.
+  void clear() {
+    for (const_iterator it = begin(); it != end(); ++it) erase(it->first);
+  }
+
+  bool contains(const Key& key) const {
+    cursor c(domain_);
+    descend(&key, false, 0, c);
+    return c.node != nullptr && !(key < c.node->kv.first);
+  }
+
+  // Returns a copy of the value, or nothing if the key is absent.
+  std::optional<T> get(const Key& key) const {
+    cursor c(domain_);
+    descend(&key, false, 0, c);
+    if (c.node == nullptr || key < c.node->kv.first) return std::nullopt;
+    return c.node->kv.second;
+  }
+
+  const_iterator find(const Key& key) const {
+    cursor c(domain_);
+    descend(&key, false, 0, c);
+    if (c.node != nullptr && key < c.node->kv.first) c.node = nullptr;
+    return const_iterator(this, c);
+  }
+
+  const_iterator lower_bound(const Key& key) const {
+    cursor c(domain_);
+    descend(&key, false, 0, c);
+    return const_iterator(this, c);
+  }
+
+  const_iterator upper_bound(const Key& key) const {
+    cursor c(domain_);
+    descend(&key, true, 0, c);
+    return const_iterator(this, c);
+  }
+
+ private:
+  // Mutable because lookups help unlink deleted nodes too.
+  mutable link head_[kMaxHeight];
+  // Tallest node ever inserted; searches start there instead of at the top.
+  std::atomic<int> height_{1};
+  alignas(64) std::atomic<size_type> size_{0};
+  mutable Domain domain_;
+
+  // Walks down to level bottom, unlinking deleted nodes on the way, and
+  // leaves c at the neighbours of key there: the last node below key and the
+  // first live node not below it. With inclusive set the walk also passes
+  // nodes equal to key, which guarantees a deleted node with that key is gone
+  // from every level. A null key stands for the smallest key.
+  void descend(const Key* key, bool inclusive, int bottom, cursor& c) const {
+    while (!try_descend(key, inclusive, bottom, c)) {
+    }
+  }
+
+  bool try_descend(const Key* key, bool inclusive, int bottom,
+                   cursor& c) const {
+    link* pred = head_;
+    Node* curr = nullptr;
+    int top = key != nullptr ? height_.load() - 1 : bottom;
+    for (int level = top; level >= bottom; --level) {
+      uintptr_t bits = c.guards[c.curr].protect(pred[level], to_node);
+      // A marked link means pred itself is being deleted.
+      if (is_marked(bits)) return false;
+      curr = to_node(bits);
+      while (curr != nullptr) {
+        uintptr_t succ = c.guards[c.succ].protect(curr->next[level], to_node);
+        // Still linked from pred, so succ was reachable when protected.
+        if (pred[level].load() != to_bits(curr)) return false;
+        if (is_marked(succ)) {
+          uintptr_t expected = to_bits(curr);
+          if (!pred[level].compare_exchange_strong(expected,
+                                                   to_bits(to_node(succ)))) {
+            return false;
+          }
+          std::swap(c.curr, c.succ);
+          curr = to_node(succ);
+        } else if (key != nullptr &&
+                   (curr->kv.first < *key ||
+                    (inclusive && !(*key < curr->kv.first)))) {
+          pred = curr->next;
+          int freed = c.pred;
+          c.pred = c.curr;
+          c.curr = c.succ;
+          c.succ = freed;
+          curr = to_node(succ);
+        } else {
+          break;
+        }
+      }
+    }
+    c.links = pred;
+    c.node = curr;
+    return true;
+  }
+
+  // Links every upper level with a walk of its own, so only the predecessor
+  // being changed has to be protected. Stops early once a deleter has started
+  // marking the node.
+  void link_upper_levels(Node* node, cursor& c) {
+    const Key& key = node->kv.first;
+    for (int level = 1; level < node->height; ++level) {
+      while (true) {
+        descend(&key, false, level, c);
+        uintptr_t bits = node->next[level].load();
+        if (is_marked(bits)) return;
+        if (to_node(bits) != c.node &&
+            !node->next[level].compare_exchange_strong(bits,
+                                                       to_bits(c.node))) {
+          return;
+        }
+        uintptr_t expected = to_bits(c.node);
+        if (c.links[level].compare_exchange_strong(expected, to_bits(node))) {
+          break;
+        }
+      }
+    }
+  }
+
+  // Moves it to the next live node. The link out of a deleted node may lead
+  // to freed memory, so if either end of the step is deleted the iterator
+  // walks down from the top to the first node above its key instead.
+  void advance(const_iterator& it) const {
+    guard hold = domain_.make_guard();
+    uintptr_t bits = hold.protect(it.current_->next[0], to_node);
+    Node* next = to_node(bits);
+    if (!is_marked(bits) &&
+        (next == nullptr || !is_marked(next->next[0].load()))) {
+      it.current_ = next;
+      if (next != nullptr) {
+        *it.guard_ = std::move(hold);
+      } else {
+        it.guard_.reset();
+      }
+      return;
+    }
+    cursor c(domain_);
+    descend(&it.current_->kv.first, true, 0, c);
+    it.guard_.reset();
+    it.current_ = c.node;
+    if (c.node != nullptr) it.guard_.emplace(std::move(c.guards[c.curr]));
+  }
+
+  // A copyable guard protects whatever its original does. A move-only one
+  // needs a fresh slot, and publishing the node there only holds it back if
+  // nobody has retired it yet; an iterator copied from one whose node is
+  // already gone moves on to the first node not below its key.
+  void copy_protection(const const_iterator& from, const_iterator& to) const {
+    if constexpr (std::is_copy_constructible_v<guard>) {
+      to.guard_ = from.guard_;
+    } else {
+      to.guard_.emplace(domain_.make_guard());
+      to.guard_->set(to.current_);
+      if (to.current_->state.load() == (kLinked | kUnlinked)) {
+        cursor c(domain_);
+        descend(&from.current_->kv.first, false, 0, c);
+        to.guard_.reset();
+        to.current_ = c.node;
+        if (c.node != nullptr) to.guard_.emplace(std::move(c.guards[c.curr]));
+      }
+    }
+  }
+
+  void raise_height(int height) {
+    int current = height_.load();
+    while (current < height &&
+           !height_.compare_exchange_weak(current, height)) {
+    }
+  }
+
+  int random_height() {
+    thread_local uint64_t state =
+        0x9e3779b97f4a7c15ULL ^ reinterpret_cast<uintptr_t>(&state);
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    int height = 1;
+    uint64_t bits = state;
+    while (height < kMaxHeight && (bits & 1)) {
+      height++;
+      bits >>= 1;
+    }
+    return height;
+  }
+
+  static Node* create_node(const Key& key, const T& value, int height) {
+    void* memory = ::operator new(sizeof(Node) + height * sizeof(link));
+    Node* node;
+    try {
+      node = new (memory) Node(key, value, height);
+    } catch (...) {
+      ::operator delete(memory);
+      throw;
+    }
+    node->next = reinterpret_cast<link*>(static_cast<char*>(memory) +
+                                         sizeof(Node));
+    for (int level = 0; level < height; ++level) {
+      new (&node->next[level]) link(0);
+    }
+    return node;
+  }
+
+  static void destroy_node(Node* node) {
+    for (int level = 0; level < node->height; ++level) {
+      node->next[level].~link();
+    }
+    node->~Node();
+    ::operator delete(node);
+  }
+
+  void retire(Node* node) {
+    domain_.retire(node, [](void* p) { destroy_node(static_cast<Node*>(p)); });
+  }
+};  // concurrent_skiplist_map
+}  // namespace lace
+#endif  // _LACE_CONCURRENT_SKIPLIST_MAP_H_
@@ -0,0 +1,205 @@
+#ifndef _LACE_COW_H_
+#define _LACE_COW_H_
+
+#include <atomic>
+#include <utility>
+
+#include "lace_map.h"
+#include "lace_set.h"
+
+namespace lace {
+
+namespace detail {
+
+// Shared, reference-counted container. Copies bump the counter; the first
+// mutation through a shared handle clones the container and leaves the others
+// untouched. The counter is atomic, so handles that share one container may
+// live on different threads. Moving is a copy, which keeps moved-from handles
+// usable.
+//
+// A handle that has given out a mutable reference into its container, via
+// write_unshareable(), can no longer share it: the reference would write
+// through to every copy. Copies of such a handle clone the container
+// straight away.
+template <typename Container>
+class cow_storage {
+  struct block {
+    Container data;
+    std::atomic<size_t> refs;
+    // Only set while refs == 1, and then only read by the owning handle.
+    bool unshareable = false;
+
+    explicit block(Container&& c) : data(std::move(c)), refs(1) {}
+    explicit block(const Container& c) : data(c), refs(1) {}
+  };
+
+ public:
+  explicit cow_storage(Container data = Container())
+      : block_(new block(std::move(data))) {}
+
+  cow_storage(const cow_storage& other) {
+    if (other.block_->unshareable) {
+      block_ = new block(static_cast<const Container&>(other.block_->data));
+    } else {
+      block_ = other.block_;
+      block_->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  cow_storage& operator=(cow_storage other) noexcept {
+    swap(other);
+    return *this;
+  }
+
+  ~cow_storage() { release(); }
+
+  void swap(cow_storage& other) noexcept { std::swap(block_, other.block_); }
+
+  const Container& read() const { return block_->data; }
+
+  Container& write() {
+    if (block_->refs.load(std::memory_order_acquire) != 1) {
+      block* copy = new block(static_cast<const Container&>(block_->data));
+      release();
+      block_ = copy;
+    }
+    return block_->data;
+  }
+
+  // Like write(), for callers that keep a mutable reference into the
+  // container.
+  Container& write_unshareable() {
+    Container& data = write();
+    block_->unshareable = true;
+    return data;
+  }
+
+  size_t use_count() const {
+    return block_->refs.load(std::memory_order_acquire);
+  }
+
+ private:
+  block* block_;
+
+  void release() {
+    if (block_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      delete block_;
+    }
+  }
+};
+
+}  // namespace detail
+
+// Opt-in copy-on-write front end for lace::map. Copies are O(1); reads go
+// straight to the shared tree, and the tree is cloned only when a shared
+// handle is first modified. Iteration is const-only so that walking a
+// shared map never triggers a clone.
+template <typename Key, typename T>
+class cow_map {
+ public:
+  using map_type = map<Key, T>;
+  using value_type = typename map_type::value_type;
+  using const_iterator = typename map_type::const_iterator;
+  using size_type = size_t;
+
+  cow_map() = default;
+  explicit cow_map(map_type tree) : storage_(std::move(tree)) {}
+  cow_map(std::initializer_list<std::pair<const Key, T>> init_list)
+      : storage_(map_type(init_list)) {}
+
+  const_iterator begin() const { return storage_.read().begin(); }
+  const_iterator end() const { return storage_.read().end(); }
+
+  size_type size() const { return storage_.read().size(); }
+  bool empty() const { return storage_.read().empty(); }
+  bool contains(const Key& key) const { return storage_.read().contains(key); }
+  const T& at(const Key& key) const { return storage_.read().at(key); }
+  const_iterator find(const Key& key) const {
+    return storage_.read().find(key);
+  }
+  const_iterator lower_bound(const Key& key) const {
+    return storage_.read().lower_bound(key);
+  }
+  const_iterator upper_bound(const Key& key) const {
+    return storage_.read().upper_bound(key);
+  }
+
+  template <typename Fn>
+  void for_each_in_range(const Key& lo, const Key& hi, Fn fn) const {
+    storage_.read().for_each_in_range(lo, hi, fn);
+  }
+
+  const map_type& base() const { return storage_.read(); }
+  bool shared() const { return storage_.use_count() > 1; }
+
+  std::pair<const_iterator, bool> insert(const Key& key, const T& value) {
+    return storage_.write().insert(key, value);
+  }
+  std::pair<const_iterator, bool> insert(const std::pair<Key, T>& pair) {
+    return storage_.write().insert(pair);
+  }
+  std::pair<const_iterator, bool> insert_or_assign(const Key& key,
+                                                   const T& value) {
+    return storage_.write().insert_or_assign(key, value);
+  }
+  void erase(const Key& key) { storage_.write().erase(key); }
+  void clear() { storage_.write().clear(); }
+
+  // The returned reference stays valid after the handle is copied, so from
+  // now on copies of this handle clone the tree instead of sharing it.
+  T& operator[](const Key& key) {
+    return storage_.write_unshareable()[key];
+  }
+
+  void swap(cow_map& other) noexcept { storage_.swap(other.storage_); }
+
+ private:
+  detail::cow_storage<map_type> storage_;
+
+};  // cow_map
+
+template <typename Key>
+class cow_set {
+ public:
+  using set_type = set<Key>;
+  using value_type = Key;
+  using const_iterator = typename set_type::const_iterator;
+  using size_type = size_t;
+
+  cow_set() = default;
+  explicit cow_set(set_type items) : storage_(std::move(items)) {}
+  cow_set(std::initializer_list<value_type> const& items)
+      : storage_(set_type(items)) {}
+
+  const_iterator begin() const { return storage_.read().begin(); }
+  const_iterator end() const { return storage_.read().end(); }
+
+  size_type size() const { return storage_.read().size(); }
+  bool empty() const { return storage_.read().empty(); }
+  bool contains(const Key& key) const { return storage_.read().contains(key); }
+  const_iterator find(const Key& key) const {
+    return storage_.read().find(key);
+  }
+
+  template <typename Fn>
+  void for_each_in_range(const Key& lo, const Key& hi, Fn fn) const {
+    storage_.read().for_each_in_range(lo, hi, fn);
+  }
+
+  const set_type& base() const { return storage_.read(); }
+  bool shared() const { return storage_.use_count() > 1; }
+
+  std::pair<const_iterator, bool> insert(const value_type& value) {
+    return storage_.write().insert(value);
+  }
+  void erase(const Key& key) { storage_.write().erase(key); }
+  void clear() { storage_.write().clear(); }
+
+  void swap(cow_set& other) noexcept { storage_.swap(other.storage_); }
+
+ private:
+  detail::cow_storage<set_type> storage_;
+
+};  // cow_set
+}  // namespace lace
+#endif  // _LACE_COW_H_
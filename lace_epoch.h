@@ -0,0 +1,311 @@
+#ifndef _LACE_EPOCH_H_
+#define _LACE_EPOCH_H_
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace lace {
+
+// Epoch-based memory reclamation domain for lock-free containers.
+//
+// A thread pins the domain before it touches shared nodes and unpins it when
+// it is done; pins nest. A node that has been unlinked is retired rather than
+// deleted. Each retirement is stamped with the global epoch, and the global
+// epoch only moves on once every pinned thread has seen its current value, so
+// a node retired at epoch e can no longer be reached by anyone once the
+// global epoch reaches e + 2.
+//
+// Threads register themselves on their first pin or retire and release their
+// slot when they exit. Retired nodes are kept in a per-thread list with no
+// shared writes; every kBatchSize retirements the thread tries to advance the
+// epoch and frees what has become safe. Garbage is bounded per thread: a
+// thread that holds max_garbage retired nodes waits, once it is no longer
+// pinned, until enough of them have been freed. A thread that stays pinned
+// indefinitely therefore stalls reclamation for everybody; hazard pointers
+// are the alternative when that matters.
+class epoch {
+ public:
+  static constexpr size_t kBatchSize = 64;
+  static constexpr size_t kDefaultMaxGarbage = 1 << 16;
+
+ private:
+  static constexpr uint64_t kIdle = std::numeric_limits<uint64_t>::max();
+
+  struct retired {
+    void* ptr;
+    void (*deleter)(void*);
+    uint64_t epoch;
+  };
+
+  struct alignas(64) record {
+    std::atomic<uint64_t> announced{kIdle};
+    std::atomic<bool> in_use{true};
+    size_t depth = 0;
+    size_t since_collect = 0;
+    std::vector<retired> garbage;
+    record* next = nullptr;
+  };
+
+  // Records outlive the domain while threads still cache them, so they live
+  // in a separately reference-counted block. Garbage left by exiting threads
+  // is adopted by the orphan list.
+  struct state {
+    std::atomic<uint64_t> epoch{0};
+    std::atomic<record*> records{nullptr};
+    std::atomic<size_t> pending{0};
+    std::atomic<bool> closed{false};
+    std::mutex mutex;
+    std::vector<retired> orphans;
+
+    ~state() {
+      record* r = records.load();
+      while (r != nullptr) {
+        record* next = r->next;
+        delete r;
+        r = next;
+      }
+    }
+  };
+
+  using state_ptr = std::shared_ptr<state>;
+
+  struct thread_cache {
+    std::vector<std::pair<state_ptr, record*>> entries;
+
+    ~thread_cache() {
+      for (auto& entry : entries) release(*entry.first, entry.second);
+    }
+  };
+
+ public:
+  // Keeps the calling thread pinned for as long as it exists. Copies nest
+  // and must stay on the thread that made them.
+  class guard {
+   public:
+    guard(const guard& other) : owner_(other.owner_), record_(other.record_) {
+      record_->depth++;
+    }
+    guard& operator=(const guard& other) {
+      guard copy(other);
+      std::swap(owner_, copy.owner_);
+      std::swap(record_, copy.record_);
+      return *this;
+    }
+    ~guard() {
+      if (--record_->depth == 0) owner_->unpin(record_);
+    }
+
+    // The lace::hazard_pointer guard interface, so a container can take
+    // either domain. The pin already protects every node, so these only
+    // load.
+    template <typename U>
+    U* protect(const std::atomic<U*>& src) const {
+      return src.load();
+    }
+    template <typename U, typename Fn>
+    U protect(const std::atomic<U>& src, Fn) const {
+      return src.load();
+    }
+    void set(const void*) const {}
+    void reset() const {}
+
+   private:
+    friend class epoch;
+
+    guard(epoch* owner, record* r) : owner_(owner), record_(r) {}
+
+    epoch* owner_;
+    record* record_;
+  };
+
+  explicit epoch(size_t max_garbage = kDefaultMaxGarbage)
+      : state_(std::make_shared<state>()),
+        max_garbage_(max_garbage < kBatchSize ? kBatchSize : max_garbage) {}
+
+  epoch(const epoch&) = delete;
+  epoch& operator=(const epoch&) = delete;
+
+  // No thread may be pinned or retiring while the domain is destroyed.
+  ~epoch() {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->closed.store(true);
+    for (record* r = state_->records.load(); r != nullptr; r = r->next) {
+      for (const retired& item : r->garbage) item.deleter(item.ptr);
+      r->garbage.clear();
+    }
+    for (const retired& item : state_->orphans) item.deleter(item.ptr);
+    state_->orphans.clear();
+  }
+
+  guard pin() {
+    record* r = local_record();
+    if (r->depth++ == 0) {
+      r->announced.store(state_->epoch.load(), std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+    return guard(this, r);
+  }
+
+  // Same as pin(); the name lace::hazard_pointer uses.
+  guard make_guard() { return pin(); }
+
+  // Hands over an unlinked node; deleter(ptr) runs once no pinned thread can
+  // still reach it.
+  void retire(void* ptr, void (*deleter)(void*)) {
+    record* r = local_record();
+    r->garbage.push_back({ptr, deleter, state_->epoch.load()});
+    state_->pending.fetch_add(1, std::memory_order_relaxed);
+    if (++r->since_collect >= kBatchSize) collect(r);
+    if (r->depth == 0 && r->garbage.size() >= max_garbage_) drain(r, false);
+  }
+
+  template <typename U>
+  void retire(U* ptr) {
+    retire(const_cast<void*>(static_cast<const void*>(ptr)),
+           [](void* p) { delete static_cast<U*>(p); });
+  }
+
+  // Advances the epoch as far as pinned threads allow and frees what the
+  // calling thread retired (and garbage orphaned by exited threads) that has
+  // become safe.
+  void reclaim() {
+    record* r = local_record();
+    for (int round = 0; round < 3 && !r->garbage.empty(); ++round) {
+      collect(r);
+    }
+    if (r->garbage.empty()) collect(r);
+  }
+
+  // Waits until everything the calling thread retired has been freed. The
+  // calling thread must not be pinned.
+  void synchronize() {
+    record* r = local_record();
+    if (r->depth != 0) {
+      throw std::logic_error("synchronize() called while pinned");
+    }
+    drain(r, true);
+  }
+
+  // Retired nodes not yet freed, over all threads.
+  size_t garbage_size() const {
+    return state_->pending.load(std::memory_order_relaxed);
+  }
+
+  size_t max_garbage() const { return max_garbage_; }
+  uint64_t current() const { return state_->epoch.load(); }
+
+ private:
+  state_ptr state_;
+  const size_t max_garbage_;
+
+  static void release(state& s, record* r) {
+    {
+      std::lock_guard<std::mutex> lock(s.mutex);
+      if (!s.closed.load()) {
+        s.orphans.insert(s.orphans.end(), r->garbage.begin(),
+                         r->garbage.end());
+      }
+      r->garbage.clear();
+    }
+    r->announced.store(kIdle, std::memory_order_relaxed);
+    r->depth = 0;
+    r->since_collect = 0;
+    r->in_use.store(false, std::memory_order_release);
+  }
+
+  record* local_record() {
+    thread_local thread_cache cache;
+    auto& entries = cache.entries;
+    for (auto it = entries.begin(); it != entries.end();) {
+      if (it->first == state_) return it->second;
+      if (it->first->closed.load(std::memory_order_relaxed)) {
+        release(*it->first, it->second);
+        it = entries.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    record* r = acquire_record();
+    entries.emplace_back(state_, r);
+    return r;
+  }
+
+  record* acquire_record() {
+    for (record* r = state_->records.load(); r != nullptr; r = r->next) {
+      bool expected = false;
+      if (!r->in_use.load(std::memory_order_relaxed) &&
+          r->in_use.compare_exchange_strong(expected, true)) {
+        return r;
+      }
+    }
+    record* r = new record();
+    r->next = state_->records.load();
+    while (!state_->records.compare_exchange_weak(r->next, r)) {
+    }
+    return r;
+  }
+
+  void unpin(record* r) {
+    r->announced.store(kIdle, std::memory_order_release);
+    if (r->garbage.size() >= max_garbage_) drain(r, false);
+  }
+
+  // Moves the global epoch on if every pinned thread has announced it.
+  // Returns the global epoch afterwards.
+  uint64_t try_advance() {
+    uint64_t global = state_->epoch.load();
+    for (record* r = state_->records.load(); r != nullptr; r = r->next) {
+      uint64_t announced = r->announced.load();
+      if (announced != kIdle && announced != global) return global;
+    }
+    if (state_->epoch.compare_exchange_strong(global, global + 1)) {
+      return global + 1;
+    }
+    return global;
+  }
+
+  size_t free_older(std::vector<retired>& items, uint64_t global) {
+    size_t kept = 0;
+    for (const retired& item : items) {
+      if (item.epoch + 2 <= global) {
+        item.deleter(item.ptr);
+      } else {
+        items[kept++] = item;
+      }
+    }
+    size_t freed = items.size() - kept;
+    items.resize(kept);
+    return freed;
+  }
+
+  void collect(record* r) {
+    r->since_collect = 0;
+    uint64_t global = try_advance();
+    size_t freed = free_older(r->garbage, global);
+    std::unique_lock<std::mutex> lock(state_->mutex, std::try_to_lock);
+    if (lock.owns_lock()) freed += free_older(state_->orphans, global);
+    state_->pending.fetch_sub(freed, std::memory_order_relaxed);
+  }
+
+  // Frees the calling thread's garbage down to half the bound, or to nothing
+  // when all is set.
+  void drain(record* r, bool all) {
+    size_t target = all ? 0 : max_garbage_ / 2;
+    collect(r);
+    while (r->garbage.size() > target) {
+      std::this_thread::yield();
+      collect(r);
+    }
+  }
+};
+
+}  // namespace lace
+
+#endif  // _LACE_EPOCH_H_
@@ -0,0 +1,296 @@
+#ifndef _LACE_HAZARD_POINTER_H_
+#define _LACE_HAZARD_POINTER_H_
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace lace {
+
+// Hazard-pointer memory reclamation domain. Instead of pinning a whole
+// epoch, a reader publishes the exact nodes it is about to use in per-thread
+// hazard slots. A retired node is freed by the next scan that finds it in no
+// slot, so a stalled reader keeps at most kSlotsPerThread nodes alive and the
+// memory held back is bounded no matter what other threads do.
+//
+// The retire interface matches lace::epoch: retire(ptr, deleter),
+// retire(ptr), reclaim() and garbage_size(). Each thread scans its own retired
+// list once it grows to twice the number of hazard slots in the domain (and
+// at least kMinScan), so after a scan at most that many nodes stay pending
+// per thread. lace::epoch::guard offers the same make_guard/protect/set/reset
+// calls as no-ops, so a container such as lace::concurrent_skiplist_map can
+// take either domain as a template argument.
+class hazard_pointer {
+ public:
+  static constexpr size_t kSlotsPerThread = 8;
+  static constexpr size_t kMinScan = 64;
+
+ private:
+  struct retired {
+    void* ptr;
+    void (*deleter)(void*);
+  };
+
+  struct alignas(64) record {
+    std::atomic<const void*> slots[kSlotsPerThread];
+    bool slot_taken[kSlotsPerThread] = {};
+    std::atomic<bool> in_use{true};
+    std::vector<retired> garbage;
+    record* next = nullptr;
+
+    record() {
+      for (auto& slot : slots) slot.store(nullptr, std::memory_order_relaxed);
+    }
+  };
+
+  // Records outlive the domain while threads still cache them; see
+  // lace::epoch.
+  struct state {
+    std::atomic<record*> records{nullptr};
+    std::atomic<size_t> record_count{0};
+    std::atomic<size_t> pending{0};
+    std::atomic<bool> closed{false};
+    std::mutex mutex;
+    std::vector<retired> orphans;
+
+    ~state() {
+      record* r = records.load();
+      while (r != nullptr) {
+        record* next = r->next;
+        delete r;
+        r = next;
+      }
+    }
+  };
+
+  using state_ptr = std::shared_ptr<state>;
+
+  struct thread_cache {
+    std::vector<std::pair<state_ptr, record*>> entries;
+
+    ~thread_cache() {
+      for (auto& entry : entries) release(*entry.first, entry.second);
+    }
+  };
+
+ public:
+  // Owns one hazard slot of the calling thread. Must stay on that thread.
+  class guard {
+   public:
+    guard(const guard&) = delete;
+    guard& operator=(const guard&) = delete;
+    guard(guard&& other) noexcept
+        : record_(other.record_), index_(other.index_) {
+      other.record_ = nullptr;
+    }
+    // Takes over other's slot, and with it whatever other protects.
+    guard& operator=(guard&& other) noexcept {
+      if (this != &other) {
+        release_slot();
+        record_ = std::exchange(other.record_, nullptr);
+        index_ = other.index_;
+      }
+      return *this;
+    }
+
+    ~guard() { release_slot(); }
+
+    // Loads src and publishes the result until the two agree, so the
+    // returned node was still reachable when it became protected.
+    template <typename U>
+    U* protect(const std::atomic<U*>& src) {
+      U* ptr = src.load();
+      while (true) {
+        record_->slots[index_].store(ptr);
+        U* again = src.load();
+        if (again == ptr) return ptr;
+        ptr = again;
+      }
+    }
+
+    // Same for a link that keeps flag bits next to the pointer: to_pointer
+    // extracts the node to publish, and the raw value is returned.
+    template <typename U, typename Fn>
+    U protect(const std::atomic<U>& src, Fn to_pointer) {
+      U value = src.load();
+      while (true) {
+        record_->slots[index_].store(to_pointer(value));
+        U again = src.load();
+        if (again == value) return value;
+        value = again;
+      }
+    }
+
+    // Publishes ptr as is; the caller must validate it is still reachable.
+    void set(const void* ptr) { record_->slots[index_].store(ptr); }
+
+    void reset() {
+      record_->slots[index_].store(nullptr, std::memory_order_release);
+    }
+
+   private:
+    friend class hazard_pointer;
+
+    guard(record* r, size_t index) : record_(r), index_(index) {}
+
+    void release_slot() {
+      if (record_ == nullptr) return;
+      reset();
+      record_->slot_taken[index_] = false;
+    }
+
+    record* record_;
+    size_t index_;
+  };
+
+  hazard_pointer() : state_(std::make_shared<state>()) {}
+
+  hazard_pointer(const hazard_pointer&) = delete;
+  hazard_pointer& operator=(const hazard_pointer&) = delete;
+
+  // No thread may hold a guard or retire while the domain is destroyed.
+  ~hazard_pointer() {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->closed.store(true);
+    for (record* r = state_->records.load(); r != nullptr; r = r->next) {
+      for (const retired& item : r->garbage) item.deleter(item.ptr);
+      r->garbage.clear();
+    }
+    for (const retired& item : state_->orphans) item.deleter(item.ptr);
+    state_->orphans.clear();
+  }
+
+  // Takes a free hazard slot of the calling thread.
+  guard make_guard() {
+    record* r = local_record();
+    for (size_t i = 0; i < kSlotsPerThread; ++i) {
+      if (!r->slot_taken[i]) {
+        r->slot_taken[i] = true;
+        return guard(r, i);
+      }
+    }
+    throw std::length_error("Out of hazard pointer slots");
+  }
+
+  // Hands over an unlinked node; deleter(ptr) runs once no hazard slot holds
+  // it.
+  void retire(void* ptr, void (*deleter)(void*)) {
+    record* r = local_record();
+    r->garbage.push_back({ptr, deleter});
+    state_->pending.fetch_add(1, std::memory_order_relaxed);
+    if (r->garbage.size() >= scan_threshold()) scan(r);
+  }
+
+  template <typename U>
+  void retire(U* ptr) {
+    retire(const_cast<void*>(static_cast<const void*>(ptr)),
+           [](void* p) { delete static_cast<U*>(p); });
+  }
+
+  // Frees everything the calling thread retired (and garbage orphaned by
+  // exited threads) that no slot protects.
+  void reclaim() { scan(local_record()); }
+
+  // Retired nodes not yet freed, over all threads.
+  size_t garbage_size() const {
+    return state_->pending.load(std::memory_order_relaxed);
+  }
+
+  // Upper bound on the nodes one thread keeps pending between scans.
+  size_t scan_threshold() const {
+    size_t hazards =
+        state_->record_count.load(std::memory_order_relaxed) * kSlotsPerThread;
+    return std::max(kMinScan, 2 * hazards);
+  }
+
+ private:
+  state_ptr state_;
+
+  static void release(state& s, record* r) {
+    {
+      std::lock_guard<std::mutex> lock(s.mutex);
+      if (!s.closed.load()) {
+        s.orphans.insert(s.orphans.end(), r->garbage.begin(),
+                         r->garbage.end());
+      }
+      r->garbage.clear();
+    }
+    for (size_t i = 0; i < kSlotsPerThread; ++i) {
+      r->slots[i].store(nullptr, std::memory_order_relaxed);
+      r->slot_taken[i] = false;
+    }
+    r->in_use.store(false, std::memory_order_release);
+  }
+
+  record* local_record() {
+    thread_local thread_cache cache;
+    auto& entries = cache.entries;
+    for (auto it = entries.begin(); it != entries.end();) {
+      if (it->first == state_) return it->second;
+      if (it->first->closed.load(std::memory_order_relaxed)) {
+        release(*it->first, it->second);
+        it = entries.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    record* r = acquire_record();
+    entries.emplace_back(state_, r);
+    return r;
+  }
+
+  record* acquire_record() {
+    for (record* r = state_->records.load(); r != nullptr; r = r->next) {
+      bool expected = false;
+      if (!r->in_use.load(std::memory_order_relaxed) &&
+          r->in_use.compare_exchange_strong(expected, true)) {
+        return r;
+      }
+    }
+    record* r = new record();
+    r->next = state_->records.load();
+    while (!state_->records.compare_exchange_weak(r->next, r)) {
+    }
+    state_->record_count.fetch_add(1, std::memory_order_relaxed);
+    return r;
+  }
+
+  size_t free_unprotected(std::vector<retired>& items,
+                          const std::vector<const void*>& hazards) {
+    size_t kept = 0;
+    for (const retired& item : items) {
+      if (std::binary_search(hazards.begin(), hazards.end(), item.ptr)) {
+        items[kept++] = item;
+      } else {
+        item.deleter(item.ptr);
+      }
+    }
+    size_t freed = items.size() - kept;
+    items.resize(kept);
+    return freed;
+  }
+
+  void scan(record* r) {
+    std::vector<const void*> hazards;
+    for (record* other = state_->records.load(); other != nullptr;
+         other = other->next) {
+      for (const auto& slot : other->slots) {
+        const void* ptr = slot.load();
+        if (ptr != nullptr) hazards.push_back(ptr);
+      }
+    }
+    std::sort(hazards.begin(), hazards.end());
+    size_t freed = free_unprotected(r->garbage, hazards);
+    std::unique_lock<std::mutex> lock(state_->mutex, std::try_to_lock);
+    if (lock.owns_lock()) freed += free_unprotected(state_->orphans, hazards);
+    state_->pending.fetch_sub(freed, std::memory_order_relaxed);
+  }
+};
+
+}  // namespace lace
+
+#endif  // _LACE_HAZARD_POINTER_H_
@@ -0,0 +1,154 @@
+#ifndef _LACE_INTRUSIVE_QUEUE_H_
+#define _LACE_INTRUSIVE_QUEUE_H_
+
+#include <atomic>
+#include <utility>
+
+namespace lace {
+
+// Link embedded in objects that go through an intrusive_queue or
+// intrusive_mpsc_queue. An object can be in one queue per hook at a time.
+template <typename T>
+struct intrusive_hook {
+  T* next = nullptr;
+};
+
+// FIFO of caller-owned objects linked through their Hook member, e.g.
+// intrusive_queue<event, &event::hook>. Push and pop relink pointers and
+// never allocate; the queue neither copies nor destroys the objects, which
+// must outlive their time in it.
+template <typename T, intrusive_hook<T> T::*Hook>
+class intrusive_queue {
+ public:
+  using value_type = T;
+  using size_type = size_t;
+
+  intrusive_queue() noexcept = default;
+  intrusive_queue(const intrusive_queue&) = delete;
+  intrusive_queue& operator=(const intrusive_queue&) = delete;
+
+  intrusive_queue(intrusive_queue&& other) noexcept { swap(other); }
+  intrusive_queue& operator=(intrusive_queue&& other) noexcept {
+    intrusive_queue(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  void push(value_type& item) noexcept {
+    (item.*Hook).next = nullptr;
+    (tail_ != nullptr ? (tail_->*Hook).next : head_) = &item;
+    tail_ = &item;
+    ++size_;
+  }
+
+  // Unlinks and returns the front object, or nullptr if the queue is empty.
+  value_type* pop() noexcept {
+    value_type* item = head_;
+    if (item == nullptr) return nullptr;
+    head_ = (item->*Hook).next;
+    if (head_ == nullptr) tail_ = nullptr;
+    (item->*Hook).next = nullptr;
+    --size_;
+    return item;
+  }
+
+  value_type* front() const noexcept { return head_; }
+  value_type* back() const noexcept { return tail_; }
+
+  // Moves every object of other to the back of this queue.
+  void append(intrusive_queue& other) noexcept {
+    if (other.head_ == nullptr) return;
+    (tail_ != nullptr ? (tail_->*Hook).next : head_) = other.head_;
+    tail_ = other.tail_;
+    size_ += other.size_;
+    other.head_ = other.tail_ = nullptr;
+    other.size_ = 0;
+  }
+
+  // Forgets the objects; they are not touched.
+  void clear() noexcept {
+    head_ = tail_ = nullptr;
+    size_ = 0;
+  }
+
+  size_type size() const noexcept { return size_; }
+  bool empty() const noexcept { return head_ == nullptr; }
+
+  void swap(intrusive_queue& other) noexcept {
+    std::swap(head_, other.head_);
+    std::swap(tail_, other.tail_);
+    std::swap(size_, other.size_);
+  }
+
+ private:
+  value_type* head_ = nullptr;
+  value_type* tail_ = nullptr;
+  size_type size_ = 0;
+};  // intrusive_queue
+
+// Lock-free multi-producer/single-consumer flavour. Producers push onto a
+// shared stack with a CAS on its head. The consumer takes the whole stack
+// with one exchange when its private queue runs dry and reverses it, so
+// objects still come out in the order their pushes took effect. Nothing is
+// allocated, and the consumer never waits for a producer.
+//
+// pop, pop_all and empty may only be called by the consumer.
+template <typename T, intrusive_hook<T> T::*Hook>
+class intrusive_mpsc_queue {
+ public:
+  using value_type = T;
+
+  intrusive_mpsc_queue() noexcept = default;
+  intrusive_mpsc_queue(const intrusive_mpsc_queue&) = delete;
+  intrusive_mpsc_queue& operator=(const intrusive_mpsc_queue&) = delete;
+
+  void push(value_type& item) noexcept {
+    value_type*& next = (item.*Hook).next;
+    next = incoming_.load(std::memory_order_relaxed);
+    while (!incoming_.compare_exchange_weak(next, &item,
+                                            std::memory_order_release,
+                                            std::memory_order_relaxed)) {
+    }
+  }
+
+  value_type* pop() noexcept {
+    if (ready_.empty()) refill();
+    return ready_.pop();
+  }
+
+  // Everything pushed so far, oldest first.
+  intrusive_queue<T, Hook> pop_all() noexcept {
+    refill();
+    return std::move(ready_);
+  }
+
+  bool empty() const noexcept {
+    return ready_.empty() &&
+           incoming_.load(std::memory_order_acquire) == nullptr;
+  }
+
+ private:
+  alignas(64) std::atomic<value_type*> incoming_{nullptr};
+  alignas(64) intrusive_queue<T, Hook> ready_;
+
+  // Moves the pushed objects, newest first on the stack, to the back of
+  // ready_ in push order.
+  void refill() noexcept {
+    value_type* item = incoming_.exchange(nullptr, std::memory_order_acquire);
+    intrusive_queue<T, Hook> batch;
+    value_type* reversed = nullptr;
+    while (item != nullptr) {
+      value_type* next = (item->*Hook).next;
+      (item->*Hook).next = reversed;
+      reversed = item;
+      item = next;
+    }
+    for (item = reversed; item != nullptr;) {
+      value_type* next = (item->*Hook).next;
+      batch.push(*item);
+      item = next;
+    }
+    ready_.append(batch);
+  }
+};  // intrusive_mpsc_queue
+}  // namespace lace
+#endif  // _LACE_INTRUSIVE_QUEUE_H_
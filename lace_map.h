@@ -1,8 +1,10 @@
 #ifndef _LACE_MAP_H_
 #define _LACE_MAP_H_
 
+#include <algorithm>
 #include <limits>
 #include <queue>
+#include <type_traits>
 #include <vector>
 
 // #include "lace_vector.h"
@@ -10,6 +12,32 @@
 
 namespace lace {
 
+namespace detail {
+
+// Bulk-build policy that builds both halves of every subtree on the calling
+// thread. lace_parallel.h provides lace::parallel_build, which hands large
+// halves to the thread pool.
+struct sequential_build {
+  template <typename Left, typename Right>
+  void fork(size_t, Left left, Right right) const {
+    left(*this);
+    right(*this);
+  }
+};
+
+// Range visitors may return void (visit everything) or bool (false stops).
+template <typename Fn, typename V>
+bool call_visitor(Fn& fn, V& value) {
+  if constexpr (std::is_void_v<std::invoke_result_t<Fn&, V&>>) {
+    fn(value);
+    return true;
+  } else {
+    return static_cast<bool>(fn(value));
+  }
+}
+
+}  // namespace detail
+
 template <typename Key, typename T>
 class map {
  public:
@@ -474,6 +502,35 @@ class map {
     return results;
   }
 
+  // Builds a map in O(n) from items whose keys are strictly increasing.
+  // The builder policy decides where the subtrees are built; pass
+  // lace::parallel_build from lace_parallel.h to use several threads.
+  template <typename InputIt, typename Builder = detail::sequential_build>
+  static map from_sorted(InputIt first, InputIt last,
+                         const Builder& builder = Builder()) {
+    return from_sorted(std::vector<std::pair<Key, T>>(first, last), builder);
+  }
+
+  template <typename Builder = detail::sequential_build>
+  static map from_sorted(std::vector<std::pair<Key, T>> items,
+                         const Builder& builder = Builder()) {
+    map result;
+    if (items.empty()) return result;
+    size_t red_depth = 0;
+    while ((size_t(2) << red_depth) <= items.size() + 1) red_depth++;
+    try {
+      result.build_subtree(items.data(), items.size(), 0, red_depth, nullptr,
+                           result.root_, builder);
+    } catch (...) {
+      result.clear();
+      throw;
+    }
+    result.size_ = items.size();
+    result.head_ = result.minimum(result.root_);
+    result.tail_ = result.maximum(result.root_);
+    return result;
+  }
+
   bool is_valid_rb_tree() const {
     if (root_ == nullptr) return true;
     if (root_->color != Color::BLACK) {
@@ -550,6 +607,89 @@ class map {
     }
     return lower;
   }
+
+  iterator lower_bound_from(const iterator& from, const Key& key) {
+    Node* node = lower_bound_from_node(from.get_current(), key);
+    return node ? iterator(node, tail_) : end();
+  }
+
+  const_iterator lower_bound_from(const const_iterator& from,
+                                  const Key& key) const {
+    Node* node =
+        lower_bound_from_node(const_cast<Node*>(from.get_current()), key);
+    return node ? const_iterator(node, tail_) : end();
+  }
+
+  iterator find_from(const iterator& from, const Key& key) {
+    Node* node = lower_bound_from_node(from.get_current(), key);
+    if (node == nullptr || key < node->kv.first) return end();
+    return iterator(node, tail_);
+  }
+
+  const_iterator find_from(const const_iterator& from, const Key& key) const {
+    Node* node =
+        lower_bound_from_node(const_cast<Node*>(from.get_current()), key);
+    if (node == nullptr || key < node->kv.first) return end();
+    return const_iterator(node, tail_);
+  }
+
+  iterator insert(const iterator& hint, const std::pair<Key, T>& pair) {
+    if (root_ == nullptr) {
+      insert_root(pair.first, pair.second);
+      return iterator(root_, tail_);
+    }
+    Node* next = lower_bound_from_node(hint.get_current(), pair.first);
+    if (next != nullptr && !(pair.first < next->kv.first)) {
+      return iterator(next, tail_);
+    }
+    Node* parent = nullptr;
+    if (next == nullptr) {
+      parent = tail_;
+    } else if (next->left == nullptr) {
+      parent = next;
+    } else {
+      parent = maximum(next->left);
+    }
+    Node* new_node = new Node(pair.first, pair.second, Color::RED, parent);
+    insert_node_final(new_node, parent);
+    return iterator(new_node, tail_);
+  }
+
+  template <typename Fn>
+  void for_each_in_range(const Key& lo, const Key& hi, Fn fn) {
+    for_each_node_in_range(lo, hi, [&fn](Node* node) {
+      return detail::call_visitor(fn, node->kv);
+    });
+  }
+
+  template <typename Fn>
+  void for_each_in_range(const Key& lo, const Key& hi, Fn fn) const {
+    for_each_node_in_range(lo, hi, [&fn](const Node* node) {
+      return detail::call_visitor(fn, node->kv);
+    });
+  }
+
+  // Cuts the elements into at most `parts` consecutive runs of roughly equal
+  // size at the roots of subtrees near the top of the tree. Returns the run
+  // boundaries, from begin() to end().
+  std::vector<const_iterator> split(size_t parts) const {
+    std::vector<const_iterator> bounds{begin()};
+    if (parts > 1 && size_ > 1) {
+      size_t depth = 1;
+      while (depth < 32 && (size_t{1} << depth) < 4 * parts) ++depth;
+      std::vector<const Node*> roots;
+      collect_subtree_roots(root_, depth, roots);
+      for (size_t i = 1; i < parts; ++i) {
+        const Node* node = roots[roots.size() * i / parts];
+        if (node != bounds.back().get_current()) {
+          bounds.emplace_back(node, tail_);
+        }
+      }
+    }
+    bounds.push_back(end());
+    return bounds;
+  }
+
   void draw() {
     if (!root_) return;
     int max_key_length = 0;
@@ -745,13 +885,52 @@ class map {
   }
 
   void copy_tree(Node* src) {
-    if (src != nullptr) {
-      insert(src->kv.first, src->kv.second);
-      copy_tree(src->left);
-      copy_tree(src->right);
-    }
-    head_ = (root_ != nullptr) ? minimum(root_) : nullptr;
-    tail_ = (root_ != nullptr) ? maximum(root_) : nullptr;
+    if (src == nullptr) return;
+    try {
+      clone_subtree(src, nullptr, root_);
+    } catch (...) {
+      clear();
+      throw;
+    }
+    head_ = minimum(root_);
+    tail_ = maximum(root_);
+  }
+
+  // Copies shape and colors as they are, so no rebalancing is needed. Each
+  // node is linked in before its children are cloned, which lets clear()
+  // release a partial copy if a copy constructor throws.
+  void clone_subtree(const Node* src, Node* parent, Node*& slot) {
+    slot = new Node(src->kv.first, src->kv.second, src->color, parent);
+    size_++;
+    if (src->left != nullptr) clone_subtree(src->left, slot, slot->left);
+    if (src->right != nullptr) clone_subtree(src->right, slot, slot->right);
+  }
+
+  // Splits around the middle element, so every null link ends up at depth
+  // red_depth or red_depth + 1. Nodes on the incomplete last level are red and
+  // every other node is black, which satisfies the red-black invariants.
+  // The builder's fork runs the two halves, passing each the policy for its
+  // own subtrees. Nodes are linked in as they are created, so a failed build
+  // can be released from the root.
+  template <typename Builder>
+  void build_subtree(const std::pair<Key, T>* items, size_t count,
+                     size_t depth, size_t red_depth, Node* parent,
+                     Node*& slot, const Builder& builder) {
+    if (count == 0) return;
+    size_t middle = count / 2;
+    Color color = depth == red_depth ? Color::RED : Color::BLACK;
+    slot = new Node(items[middle].first, items[middle].second, color, parent);
+    Node* node = slot;
+    builder.fork(
+        count,
+        [=](const auto& half) {
+          build_subtree(items, middle, depth + 1, red_depth, node, node->left,
+                        half);
+        },
+        [=](const auto& half) {
+          build_subtree(items + middle + 1, count - middle - 1, depth + 1,
+                        red_depth, node, node->right, half);
+        });
   }
 
   void fix_insert(Node* node) {
@@ -880,6 +1059,75 @@ class map {
     return nullptr;
   }
 
+  // Finger search: climbs from `start` only until the subtree above it is
+  // known to hold the answer, then descends as lower_bound does.
+  Node* lower_bound_from_node(Node* start, const Key& key) const {
+    Node* node = start ? start : root_;
+    Node* bound = nullptr;
+    if (start != nullptr && start->kv.first < key) {
+      while (node->parent != nullptr) {
+        Node* parent = node->parent;
+        if (node == parent->left && !(parent->kv.first < key)) {
+          bound = parent;
+          break;
+        }
+        node = parent;
+      }
+    } else if (start != nullptr) {
+      if (!(key < start->kv.first)) return start;
+      while (node->parent != nullptr) {
+        Node* parent = node->parent;
+        if (node == parent->right && parent->kv.first < key) break;
+        node = parent;
+      }
+    }
+    while (node != nullptr) {
+      if (key < node->kv.first) {
+        bound = node;
+        node = node->left;
+      } else if (node->kv.first < key) {
+        node = node->right;
+      } else {
+        return node;
+      }
+    }
+    return bound;
+  }
+
+  // In-order walk of [lo, hi) with an explicit stack. The stack only ever
+  // holds part of one root-to-leaf path, and a red-black tree is at most
+  // 2 * log2(n + 1) deep, so a fixed array is enough.
+  template <typename Visit>
+  void for_each_node_in_range(const Key& lo, const Key& hi,
+                              Visit&& visit) const {
+    Node* stack[2 * std::numeric_limits<size_t>::digits];
+    size_t depth = 0;
+    for (Node* node = root_; node != nullptr;) {
+      if (node->kv.first < lo) {
+        node = node->right;
+      } else {
+        stack[depth++] = node;
+        node = node->left;
+      }
+    }
+    while (depth > 0) {
+      Node* current = stack[--depth];
+      if (!(current->kv.first < hi) || !visit(current)) return;
+      for (Node* node = current->right; node != nullptr; node = node->left) {
+        stack[depth++] = node;
+      }
+    }
+  }
+
+  // In-order list of the nodes less than `depth` levels below node.
+  void collect_subtree_roots(const Node* node, size_t depth,
+                             std::vector<const Node*>& out) const {
+    if (node == nullptr || depth == 0) return;
+    collect_subtree_roots(node->left, depth - 1, out);
+    out.push_back(node);
+    collect_subtree_roots(node->right, depth - 1, out);
+  }
+
   Node* minimum(Node* node) const {
     while (node->left != nullptr) node = node->left;
     return node;
@@ -0,0 +1,191 @@
+#ifndef _LACE_MPMC_QUEUE_H_
+#define _LACE_MPMC_QUEUE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace lace {
+
+// Bounded lock-free multi-producer/multi-consumer queue over an array of
+// sequence-numbered slots (D. Vyukov's design). Slot i starts with sequence
+// i. A producer that claims position p through a CAS on the tail may fill the
+// slot once its sequence equals p, and then sets it to p + 1; a consumer that
+// claims p from the head waits for p + 1, empties the slot and sets it to
+// p + capacity, handing it to the producer of the next lap. Producers and
+// consumers only contend on their own counter and on the slot they claimed,
+// and every slot has its own cache line.
+//
+// The blocking push and pop spin briefly and then yield until they succeed.
+template <typename T>
+class mpmc_queue {
+ public:
+  using value_type = T;
+  using size_type = size_t;
+
+  // The capacity is rounded up to a power of two, and to at least 2. Throws
+  // std::length_error when it exceeds max_capacity().
+  explicit mpmc_queue(size_type capacity) {
+    if (capacity > max_capacity()) {
+      throw std::length_error("mpmc_queue capacity too large");
+    }
+    capacity_ = 2;
+    while (capacity_ < capacity) capacity_ *= 2;
+    slots_ = std::make_unique<slot[]>(capacity_);
+    for (size_t i = 0; i < capacity_; ++i) {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  mpmc_queue(const mpmc_queue&) = delete;
+  mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+  // No thread may use the queue while it is destroyed.
+  ~mpmc_queue() {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    for (size_t i = head_.load(std::memory_order_relaxed); i != tail; ++i) {
+      slots_[i & (capacity_ - 1)].item()->~value_type();
+    }
+  }
+
+  bool try_push(const value_type& value) { return try_emplace(value); }
+  bool try_push(value_type&& value) { return try_emplace(std::move(value)); }
+
+  // Once a slot is claimed its sequence must be published, so a value whose
+  // constructor may throw is built before claiming one and then moved in.
+  template <typename... Args>
+  bool try_emplace(Args&&... args) {
+    if constexpr (std::is_nothrow_constructible_v<value_type, Args...>) {
+      return claim([&](void* storage) {
+        new (storage) value_type(std::forward<Args>(args)...);
+      });
+    } else {
+      static_assert(std::is_nothrow_move_constructible_v<value_type>,
+                    "mpmc_queue needs a nothrow move constructor to emplace "
+                    "from a throwing constructor");
+      value_type value(std::forward<Args>(args)...);
+      return claim([&](void* storage) {
+        new (storage) value_type(std::move(value));
+      });
+    }
+  }
+
+  bool try_pop(value_type& out) {
+    size_t pos = head_.load(std::memory_order_relaxed);
+    while (true) {
+      slot& s = slots_[pos & (capacity_ - 1)];
+      size_t sequence = s.sequence.load(std::memory_order_acquire);
+      intptr_t lag = static_cast<intptr_t>(sequence - (pos + 1));
+      if (lag == 0) {
+        if (head_.compare_exchange_weak(pos, pos + 1,
+                                        std::memory_order_relaxed)) {
+          // Frees the slot even if the move assignment throws, in which
+          // case the element is lost but the queue keeps working.
+          slot_release release{s, pos + capacity_};
+          out = std::move(*s.item());
+          return true;
+        }
+      } else if (lag < 0) {
+        return false;
+      } else {
+        pos = head_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  void push(const value_type& value) {
+    wait_until([&] { return try_push(value); });
+  }
+  void push(value_type&& value) {
+    wait_until([&] { return try_push(std::move(value)); });
+  }
+
+  void pop(value_type& out) {
+    wait_until([&] { return try_pop(out); });
+  }
+
+  // Approximate while other threads push or pop.
+  size_type size() const {
+    size_t head = head_.load(std::memory_order_acquire);
+    size_t tail = tail_.load(std::memory_order_acquire);
+    return tail > head ? tail - head : 0;
+  }
+  bool empty() const { return size() == 0; }
+  size_type capacity() const { return capacity_; }
+
+  // Largest power of two slots that fit in memory.
+  static constexpr size_type max_capacity() {
+    size_type limit = std::numeric_limits<size_type>::max() / sizeof(slot);
+    size_type capacity = 2;
+    while (capacity <= limit / 2) capacity *= 2;
+    return capacity;
+  }
+
+ private:
+  static constexpr int kSpins = 64;
+
+  struct alignas(64) slot {
+    std::atomic<size_t> sequence;
+    alignas(value_type) unsigned char storage[sizeof(value_type)];
+
+    value_type* item() {
+      return std::launder(reinterpret_cast<value_type*>(storage));
+    }
+  };
+
+  alignas(64) std::atomic<size_t> tail_{0};
+  alignas(64) std::atomic<size_t> head_{0};
+  alignas(64) std::unique_ptr<slot[]> slots_;
+  size_type capacity_;
+
+  struct slot_release {
+    slot& s;
+    size_t next_sequence;
+
+    ~slot_release() {
+      s.item()->~value_type();
+      s.sequence.store(next_sequence, std::memory_order_release);
+    }
+  };
+
+  // Claims the next free slot, runs build(storage), which must not throw,
+  // and publishes the slot. Returns false if the queue is full.
+  template <typename Build>
+  bool claim(Build build) {
+    size_t pos = tail_.load(std::memory_order_relaxed);
+    while (true) {
+      slot& s = slots_[pos & (capacity_ - 1)];
+      size_t sequence = s.sequence.load(std::memory_order_acquire);
+      intptr_t lag = static_cast<intptr_t>(sequence - pos);
+      if (lag == 0) {
+        if (tail_.compare_exchange_weak(pos, pos + 1,
+                                        std::memory_order_relaxed)) {
+          build(static_cast<void*>(s.storage));
+          s.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (lag < 0) {
+        return false;
+      } else {
+        pos = tail_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // A failed try_push does not consume its argument, so retrying with the
+  // same rvalue is safe.
+  template <typename Attempt>
+  static void wait_until(Attempt attempt) {
+    for (int spin = 0; !attempt(); ++spin) {
+      if (spin >= kSpins) std::this_thread::yield();
+    }
+  }
+};  // mpmc_queue
+}  // namespace lace
+#endif  // _LACE_MPMC_QUEUE_H_
@@ -228,6 +228,14 @@ class multiset {
     return iterator(tree_.find(value), 0);
   }
 
+  // Adds count copies of value at once.
+  iterator insert(const value_type& value, size_type count) {
+    if (count == 0) return find(value);
+    tree_[value] += count;
+    size_ += count;
+    return iterator(tree_.find(value), 0);
+  }
+
   void insert(std::initializer_list<Key> keys) {
     for (const auto& key : keys) {
       tree_[key]++;
@@ -320,6 +328,29 @@ class multiset {
             const_iterator(tree_pair.second, 0)};
   }
 
+  // Builds a multiset in O(n) from (key, count) pairs with strictly
+  // increasing keys and non-zero counts, with the subtrees built where the
+  // builder policy says (see map::from_sorted).
+  template <typename Builder = detail::sequential_build>
+  static multiset from_counts(std::vector<std::pair<Key, size_type>> counts,
+                              const Builder& builder = Builder()) {
+    multiset result;
+    for (const auto& kv : counts) result.size_ += kv.second;
+    result.tree_ = tree_type::from_sorted(std::move(counts), builder);
+    return result;
+  }
+
+  template <typename Fn>
+  void for_each_in_range(const key_type& lo, const key_type& hi,
+                         Fn fn) const {
+    tree_.for_each_in_range(lo, hi, [&fn](const auto& kv) {
+      for (size_type i = 0; i < kv.second; ++i) {
+        if (!detail::call_visitor(fn, kv.first)) return false;
+      }
+      return true;
+    });
+  }
+
   template <typename... Args>
   std::vector<std::pair<iterator, bool>> insert_many(Args&&... args) {
     static_assert((std::is_convertible_v<Args, Key> && ...),
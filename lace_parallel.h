@@ -0,0 +1,348 @@
+#ifndef _LACE_PARALLEL_H_
+#define _LACE_PARALLEL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "lace_multiset.h"
+#include "lace_set.h"
+#include "lace_thread_pool.h"
+
+namespace lace {
+
+namespace detail {
+
+inline unsigned default_thread_count() {
+  unsigned threads = std::thread::hardware_concurrency();
+  return threads == 0 ? 1 : threads;
+}
+
+// Below this many elements per thread the cost of starting threads is larger
+// than the work they would take over.
+constexpr size_t kParallelGrain = 1 << 14;
+
+// Sorts equal chunks on separate threads, then merges neighbouring runs in
+// rounds, each round in parallel. Every step is stable, so equal elements
+// keep their input order.
+template <typename RandomIt, typename Compare>
+void parallel_stable_sort(RandomIt first, RandomIt last, Compare comp,
+                          unsigned threads) {
+  size_t size = static_cast<size_t>(last - first);
+  size_t chunks = std::min<size_t>(threads, size / kParallelGrain);
+  if (chunks <= 1) {
+    std::stable_sort(first, last, comp);
+    return;
+  }
+
+  std::vector<RandomIt> bounds;
+  for (size_t i = 0; i <= chunks; ++i) {
+    bounds.push_back(first + static_cast<std::ptrdiff_t>(size * i / chunks));
+  }
+
+  task_group sorts;
+  for (size_t i = 0; i < chunks; ++i) {
+    sorts.run([&bounds, comp, i] {
+      std::stable_sort(bounds[i], bounds[i + 1], comp);
+    });
+  }
+  sorts.wait();
+
+  for (size_t width = 1; width < chunks; width *= 2) {
+    task_group merges;
+    for (size_t i = 0; i + width < chunks; i += 2 * width) {
+      size_t end = std::min(i + 2 * width, chunks);
+      merges.run([&bounds, comp, i, width, end] {
+        std::inplace_merge(bounds[i], bounds[i + width], bounds[end], comp);
+      });
+    }
+    merges.wait();
+  }
+}
+
+// A partial result on its own cache line. Keeping the partials of different
+// workers apart avoids false sharing, and unlike std::vector<bool> elements
+// they can be written concurrently.
+template <typename T>
+struct alignas(64) padded {
+  T value;
+};
+
+// Work units per thread for the tree algorithms below. Subtrees are only
+// roughly equal, so a few units each let fast threads take over the rest.
+constexpr size_t kUnitsPerThread = 4;
+
+// Splits c into work units and runs work(worker, unit, first, last) on them
+// from up to `threads` workers on the shared thread_pool; each worker takes
+// the next unit off a shared counter. Returns the number of workers used.
+template <typename Container, typename Work>
+size_t run_units(const Container& c, unsigned threads, Work work) {
+  size_t workers = std::min<size_t>(threads, c.size() / kParallelGrain);
+  if (workers <= 1) {
+    work(size_t{0}, size_t{0}, c.begin(), c.end());
+    return 1;
+  }
+  auto bounds = c.split(workers * kUnitsPerThread);
+  std::atomic<size_t> next{0};
+  auto loop = [&](size_t worker) {
+    for (size_t unit = next++; unit + 1 < bounds.size(); unit = next++) {
+      work(worker, unit, bounds[unit], bounds[unit + 1]);
+    }
+  };
+  task_group group;
+  for (size_t worker = 1; worker < workers; ++worker) {
+    group.run([&loop, worker] { loop(worker); });
+  }
+  loop(0);
+  group.wait();
+  return workers;
+}
+
+}  // namespace detail
+
+// Calls fn on every element of c, which must provide split() (lace::map,
+// lace::set). Elements are visited concurrently in no particular order.
+template <typename Container, typename Fn>
+void parallel_for_each(const Container& c, Fn fn,
+                       unsigned threads = detail::default_thread_count()) {
+  detail::run_units(c, threads, [&fn](size_t, size_t, auto it, auto last) {
+    for (; it != last; ++it) fn(*it);
+  });
+}
+
+// Folds the elements of c with fold(T, element) and merges partial results
+// with combine(T, T). Every work unit starts from identity, which must be
+// neutral for combine, and partial results are combined in no particular
+// order, so combine must be associative and commutative.
+template <typename Container, typename T, typename Fold, typename Combine>
+T parallel_reduce(const Container& c, T identity, Fold fold, Combine combine,
+                  unsigned threads) {
+  size_t slots = std::max<size_t>(threads, 1);
+  std::vector<detail::padded<T>> partial(slots, {identity});
+  size_t workers = detail::run_units(
+      c, threads, [&](size_t worker, size_t, auto it, auto last) {
+        T acc = std::move(partial[worker].value);
+        for (; it != last; ++it) acc = fold(std::move(acc), *it);
+        partial[worker].value = std::move(acc);
+      });
+  T result = std::move(partial[0].value);
+  for (size_t i = 1; i < workers; ++i) {
+    result = combine(std::move(result), std::move(partial[i].value));
+  }
+  return result;
+}
+
+// Shorthand for when op can both fold an element into a T and combine two
+// Ts, e.g. std::plus<>() over a set of numbers.
+template <typename Container, typename T, typename Op>
+T parallel_reduce(const Container& c, T identity, Op op) {
+  return parallel_reduce(c, std::move(identity), op, op,
+                         detail::default_thread_count());
+}
+
+// Like parallel_reduce, but the result is
+// combine(...combine(unit_0, unit_1)..., unit_n) over the work units in key
+// order, so combine only has to be associative. Use this for order-sensitive
+// reductions such as concatenation.
+template <typename Container, typename T, typename Fold, typename Combine>
+T parallel_reduce_ordered(const Container& c, T identity, Fold fold,
+                          Combine combine, unsigned threads) {
+  size_t units = std::max<size_t>(threads, 1) * detail::kUnitsPerThread;
+  std::vector<detail::padded<T>> partial(units, {identity});
+  detail::run_units(c, threads, [&](size_t, size_t unit, auto it, auto last) {
+    T acc = std::move(partial[unit].value);
+    for (; it != last; ++it) acc = fold(std::move(acc), *it);
+    partial[unit].value = std::move(acc);
+  });
+  T result = std::move(partial[0].value);
+  for (size_t i = 1; i < units; ++i) {
+    result = combine(std::move(result), std::move(partial[i].value));
+  }
+  return result;
+}
+
+template <typename Container, typename T, typename Op>
+T parallel_reduce_ordered(const Container& c, T identity, Op op) {
+  return parallel_reduce_ordered(c, std::move(identity), op, op,
+                                 detail::default_thread_count());
+}
+
+// Bulk-build policy for map::from_sorted, set::from_sorted and
+// multiset::from_counts that builds the halves of large subtrees on the
+// shared thread_pool until the thread budget is spent.
+class parallel_build {
+ public:
+  explicit parallel_build(unsigned threads = detail::default_thread_count())
+      : threads_(threads) {}
+
+  template <typename Left, typename Right>
+  void fork(size_t count, Left left, Right right) const {
+    if (threads_ > 1 && count > detail::kParallelGrain) {
+      task_group group;
+      group.run([&left, this] { left(parallel_build(threads_ / 2)); });
+      right(parallel_build(threads_ - threads_ / 2));
+      group.wait();
+    } else {
+      detail::sequential_build().fork(count, std::move(left),
+                                      std::move(right));
+    }
+  }
+
+ private:
+  unsigned threads_;
+};
+
+namespace detail {
+
+template <typename Container>
+struct parallel_builder;
+
+template <typename Key, typename T>
+struct parallel_builder<map<Key, T>> {
+  template <typename InputIt>
+  static map<Key, T> build(InputIt first, InputIt last, unsigned threads) {
+    std::vector<std::pair<Key, T>> items(first, last);
+    auto key_less = [](const std::pair<Key, T>& a, const std::pair<Key, T>& b) {
+      return a.first < b.first;
+    };
+    parallel_stable_sort(items.begin(), items.end(), key_less, threads);
+    items.erase(std::unique(items.begin(), items.end(),
+                            [&key_less](const auto& a, const auto& b) {
+                              return !key_less(a, b) && !key_less(b, a);
+                            }),
+                items.end());
+    return map<Key, T>::from_sorted(std::move(items), parallel_build(threads));
+  }
+};
+
+template <typename Key>
+struct parallel_builder<set<Key>> {
+  template <typename InputIt>
+  static set<Key> build(InputIt first, InputIt last, unsigned threads) {
+    std::vector<Key> keys(first, last);
+    auto less = [](const Key& a, const Key& b) { return a < b; };
+    parallel_stable_sort(keys.begin(), keys.end(), less, threads);
+    keys.erase(std::unique(keys.begin(), keys.end(),
+                           [&less](const Key& a, const Key& b) {
+                             return !less(a, b) && !less(b, a);
+                           }),
+               keys.end());
+    return set<Key>::from_sorted(std::move(keys), parallel_build(threads));
+  }
+};
+
+// Collapses equal runs of the sorted keys into counts.
+template <typename Key>
+struct parallel_builder<multiset<Key>> {
+  template <typename InputIt>
+  static multiset<Key> build(InputIt first, InputIt last, unsigned threads) {
+    std::vector<Key> keys(first, last);
+    parallel_stable_sort(
+        keys.begin(), keys.end(),
+        [](const Key& a, const Key& b) { return a < b; }, threads);
+    std::vector<std::pair<Key, size_t>> counts;
+    for (const auto& key : keys) {
+      if (counts.empty() || counts.back().first < key) {
+        counts.emplace_back(key, 1);
+      } else {
+        counts.back().second++;
+      }
+    }
+    return multiset<Key>::from_counts(std::move(counts),
+                                      parallel_build(threads));
+  }
+};
+
+// Merges both sets in one pass and bulk-builds the result. With several
+// threads, the larger set is cut at subtree boundaries, the smaller one at
+// the same keys, and the pieces are merged concurrently.
+template <typename Key>
+set<Key> parallel_merge_sets(const set<Key>& left, const set<Key>& right,
+                             unsigned keep, unsigned threads) {
+  size_t total = left.size() + right.size();
+  size_t workers = std::min<size_t>(threads, total / kParallelGrain);
+  if (workers <= 1) return merge_sets(left, right, keep);
+
+  bool left_larger = right.size() <= left.size();
+  const set<Key>& larger = left_larger ? left : right;
+  const set<Key>& smaller = left_larger ? right : left;
+  auto larger_bounds = larger.split(workers * kUnitsPerThread);
+  std::vector<typename set<Key>::const_iterator> smaller_bounds{
+      smaller.begin()};
+  for (size_t i = 1; i + 1 < larger_bounds.size(); ++i) {
+    smaller_bounds.push_back(
+        smaller.lower_bound_from(smaller.end(), *larger_bounds[i]));
+  }
+  smaller_bounds.push_back(smaller.end());
+
+  size_t parts = larger_bounds.size() - 1;
+  std::vector<std::vector<Key>> pieces(parts);
+  std::atomic<size_t> next{0};
+  auto loop = [&] {
+    for (size_t i = next++; i < parts; i = next++) {
+      auto& l = left_larger ? larger_bounds : smaller_bounds;
+      auto& r = left_larger ? smaller_bounds : larger_bounds;
+      merge_walk(l[i], l[i + 1], r[i], r[i + 1], keep, pieces[i]);
+    }
+  };
+  task_group group;
+  for (size_t i = 1; i < workers; ++i) group.run(loop);
+  loop();
+  group.wait();
+
+  size_t size = 0;
+  for (const auto& piece : pieces) size += piece.size();
+  std::vector<Key> keys;
+  keys.reserve(size);
+  for (auto& piece : pieces) {
+    std::move(piece.begin(), piece.end(), std::back_inserter(keys));
+  }
+  return set<Key>::from_sorted(std::move(keys), parallel_build(threads));
+}
+
+}  // namespace detail
+
+// Builds a lace::map, lace::set or lace::multiset from unsorted input:
+// parallel stable sort, then the linear bulk build with subtrees built on
+// separate threads. Like a loop of insert() calls, the first of several
+// equal map keys wins.
+template <typename Container, typename InputIt>
+Container build_parallel(InputIt first, InputIt last,
+                         unsigned threads = detail::default_thread_count()) {
+  return detail::parallel_builder<Container>::build(first, last, threads);
+}
+
+// Set algebra that merges large inputs on several threads.
+template <typename Key>
+set<Key> set_union(const set<Key>& left, const set<Key>& right,
+                   unsigned threads) {
+  return detail::parallel_merge_sets(
+      left, right, detail::kLeftOnly | detail::kRightOnly | detail::kBoth,
+      threads);
+}
+
+template <typename Key>
+set<Key> set_intersection(const set<Key>& left, const set<Key>& right,
+                          unsigned threads) {
+  return detail::parallel_merge_sets(left, right, detail::kBoth, threads);
+}
+
+template <typename Key>
+set<Key> set_difference(const set<Key>& left, const set<Key>& right,
+                        unsigned threads) {
+  return detail::parallel_merge_sets(left, right, detail::kLeftOnly, threads);
+}
+
+template <typename Key>
+set<Key> symmetric_difference(const set<Key>& left, const set<Key>& right,
+                              unsigned threads) {
+  return detail::parallel_merge_sets(
+      left, right, detail::kLeftOnly | detail::kRightOnly, threads);
+}
+
+}  // namespace lace
+
+#endif  // _LACE_PARALLEL_H_
@@ -0,0 +1,335 @@
+#ifndef _LACE_PERSISTENT_MAP_H_
+#define _LACE_PERSISTENT_MAP_H_
+
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "lace_map.h"
+
+namespace lace {
+
+// Immutable AVL tree with path copying. Every update copies only the nodes on
+// the path to the changed key and shares the rest, so copies and snapshot()
+// are O(1). Subtrees are reference counted with std::shared_ptr, which makes
+// it safe to hand snapshots to other threads; a single handle must still not
+// be written and read concurrently.
+template <typename Key, typename T>
+class persistent_map {
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<const Key, T>;
+  using size_type = size_t;
+
+ private:
+  struct Node;
+  using NodePtr = std::shared_ptr<const Node>;
+
+  struct Node {
+    value_type kv;
+    NodePtr left;
+    NodePtr right;
+    int height;
+
+    Node(const value_type& value, NodePtr l, NodePtr r)
+        : kv(value),
+          left(std::move(l)),
+          right(std::move(r)),
+          height(1 + std::max(height_of(left), height_of(right))) {}
+  };
+
+ public:
+  class const_iterator {
+   public:
+    const_iterator() = default;
+
+    const value_type& operator*() const {
+      if (stack_.empty()) {
+        throw std::runtime_error("Dereferencing end iterator");
+      }
+      return stack_.back()->kv;
+    }
+
+    const value_type* operator->() const {
+      if (stack_.empty()) throw std::runtime_error("Accessing end iterator");
+      return &stack_.back()->kv;
+    }
+
+    const_iterator& operator++() {
+      if (stack_.empty()) {
+        throw std::runtime_error("Incrementing an end iterator");
+      }
+      const Node* node = stack_.back();
+      stack_.pop_back();
+      push_left(node->right.get());
+      return *this;
+    }
+
+    const_iterator operator++(int) {
+      const_iterator temp = *this;
+      ++(*this);
+      return temp;
+    }
+
+    bool operator==(const const_iterator& other) const {
+      if (stack_.empty() || other.stack_.empty()) {
+        return stack_.empty() && other.stack_.empty();
+      }
+      return stack_.back() == other.stack_.back();
+    }
+
+    bool operator!=(const const_iterator& other) const {
+      return !(*this == other);
+    }
+
+   private:
+    friend class persistent_map;
+
+    std::vector<const Node*> stack_;
+
+    void push_left(const Node* node) {
+      for (; node != nullptr; node = node->left.get()) stack_.push_back(node);
+    }
+  };
+
+  using iterator = const_iterator;
+
+  persistent_map() : root_(nullptr), size_(0) {}
+
+  persistent_map(std::initializer_list<std::pair<const Key, T>> init_list)
+      : persistent_map() {
+    for (const auto& item : init_list) insert(item.first, item.second);
+  }
+
+  explicit persistent_map(const map<Key, T>& source) : persistent_map() {
+    std::vector<const value_type*> items;
+    items.reserve(source.size());
+    for (const auto& item : source) items.push_back(&item);
+    root_ = build(items, 0, items.size());
+    size_ = items.size();
+  }
+
+  persistent_map(const persistent_map& other) = default;
+  persistent_map(persistent_map&& other) noexcept
+      : root_(std::move(other.root_)), size_(other.size_) {
+    other.size_ = 0;
+  }
+
+  persistent_map& operator=(persistent_map other) noexcept {
+    swap(other);
+    return *this;
+  }
+
+  ~persistent_map() = default;
+
+  persistent_map snapshot() const { return *this; }
+
+  const_iterator begin() const {
+    const_iterator it;
+    it.push_left(root_.get());
+    return it;
+  }
+  const_iterator end() const { return const_iterator(); }
+
+  size_type size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  void clear() {
+    root_.reset();
+    size_ = 0;
+  }
+
+  void swap(persistent_map& other) noexcept {
+    root_.swap(other.root_);
+    std::swap(size_, other.size_);
+  }
+
+  bool contains(const Key& key) const { return find_node(key) != nullptr; }
+
+  const T& at(const Key& key) const {
+    const Node* node = find_node(key);
+    if (node == nullptr) throw std::out_of_range("Key not found");
+    return node->kv.second;
+  }
+
+  // Like at(), but returns nullptr for a missing key and builds no iterator.
+  const T* lookup(const Key& key) const {
+    const Node* node = find_node(key);
+    return node == nullptr ? nullptr : &node->kv.second;
+  }
+
+  const_iterator find(const Key& key) const {
+    const_iterator it;
+    const Node* node = root_.get();
+    while (node != nullptr) {
+      it.stack_.push_back(node);
+      if (key < node->kv.first) {
+        node = node->left.get();
+      } else if (node->kv.first < key) {
+        it.stack_.pop_back();
+        node = node->right.get();
+      } else {
+        return it;
+      }
+    }
+    return end();
+  }
+
+  const_iterator lower_bound(const Key& key) const {
+    const_iterator it;
+    const Node* node = root_.get();
+    while (node != nullptr) {
+      if (node->kv.first < key) {
+        node = node->right.get();
+      } else {
+        it.stack_.push_back(node);
+        if (!(key < node->kv.first)) break;
+        node = node->left.get();
+      }
+    }
+    return it;
+  }
+
+  bool insert(const Key& key, const T& value) {
+    bool inserted = false;
+    root_ = insert_node(root_, value_type(key, value), false, inserted);
+    if (inserted) size_++;
+    return inserted;
+  }
+
+  bool insert(const std::pair<Key, T>& pair) {
+    return insert(pair.first, pair.second);
+  }
+
+  bool insert_or_assign(const Key& key, const T& value) {
+    bool inserted = false;
+    root_ = insert_node(root_, value_type(key, value), true, inserted);
+    if (inserted) size_++;
+    return inserted;
+  }
+
+  bool erase(const Key& key) {
+    bool erased = false;
+    root_ = erase_node(root_, key, erased);
+    if (erased) size_--;
+    return erased;
+  }
+
+  bool is_balanced() const { return check_balance(root_.get()) >= 0; }
+
+ private:
+  NodePtr root_;
+  size_type size_;
+
+  static int height_of(const NodePtr& node) { return node ? node->height : 0; }
+
+  static NodePtr make_node(const value_type& kv, NodePtr left, NodePtr right) {
+    return std::make_shared<const Node>(kv, std::move(left), std::move(right));
+  }
+
+  static NodePtr balance(const value_type& kv, NodePtr left, NodePtr right) {
+    int diff = height_of(left) - height_of(right);
+    if (diff > 1) {
+      if (height_of(left->left) >= height_of(left->right)) {
+        return make_node(left->kv, left->left,
+                         make_node(kv, left->right, std::move(right)));
+      }
+      const Node* pivot = left->right.get();
+      return make_node(pivot->kv, make_node(left->kv, left->left, pivot->left),
+                       make_node(kv, pivot->right, std::move(right)));
+    }
+    if (diff < -1) {
+      if (height_of(right->right) >= height_of(right->left)) {
+        return make_node(right->kv, make_node(kv, std::move(left), right->left),
+                         right->right);
+      }
+      const Node* pivot = right->left.get();
+      return make_node(pivot->kv, make_node(kv, std::move(left), pivot->left),
+                       make_node(right->kv, pivot->right, right->right));
+    }
+    return make_node(kv, std::move(left), std::move(right));
+  }
+
+  static NodePtr insert_node(const NodePtr& node, const value_type& kv,
+                             bool assign, bool& inserted) {
+    if (node == nullptr) {
+      inserted = true;
+      return make_node(kv, nullptr, nullptr);
+    }
+    if (kv.first < node->kv.first) {
+      NodePtr left = insert_node(node->left, kv, assign, inserted);
+      if (left == node->left) return node;
+      return balance(node->kv, std::move(left), node->right);
+    } else if (node->kv.first < kv.first) {
+      NodePtr right = insert_node(node->right, kv, assign, inserted);
+      if (right == node->right) return node;
+      return balance(node->kv, node->left, std::move(right));
+    }
+    if (!assign) return node;
+    return make_node(kv, node->left, node->right);
+  }
+
+  static NodePtr erase_min(const NodePtr& node) {
+    if (node->left == nullptr) return node->right;
+    return balance(node->kv, erase_min(node->left), node->right);
+  }
+
+  static NodePtr erase_node(const NodePtr& node, const Key& key,
+                            bool& erased) {
+    if (node == nullptr) return node;
+    if (key < node->kv.first) {
+      NodePtr left = erase_node(node->left, key, erased);
+      if (!erased) return node;
+      return balance(node->kv, std::move(left), node->right);
+    } else if (node->kv.first < key) {
+      NodePtr right = erase_node(node->right, key, erased);
+      if (!erased) return node;
+      return balance(node->kv, node->left, std::move(right));
+    }
+    erased = true;
+    if (node->left == nullptr) return node->right;
+    if (node->right == nullptr) return node->left;
+    const Node* successor = node->right.get();
+    while (successor->left != nullptr) successor = successor->left.get();
+    return balance(successor->kv, node->left, erase_min(node->right));
+  }
+
+  static NodePtr build(const std::vector<const value_type*>& items,
+                       size_t first, size_t last) {
+    if (first == last) return nullptr;
+    size_t middle = first + (last - first) / 2;
+    NodePtr left = build(items, first, middle);
+    NodePtr right = build(items, middle + 1, last);
+    return make_node(*items[middle], std::move(left), std::move(right));
+  }
+
+  const Node* find_node(const Key& key) const {
+    const Node* node = root_.get();
+    while (node != nullptr) {
+      if (key < node->kv.first) {
+        node = node->left.get();
+      } else if (node->kv.first < key) {
+        node = node->right.get();
+      } else {
+        return node;
+      }
+    }
+    return nullptr;
+  }
+
+  int check_balance(const Node* node) const {
+    if (node == nullptr) return 0;
+    int left = check_balance(node->left.get());
+    int right = check_balance(node->right.get());
+    if (left < 0 || right < 0 || left - right > 1 || right - left > 1 ||
+        node->height != 1 + std::max(left, right)) {
+      return -1;
+    }
+    return node->height;
+  }
+
+};  // persistent_map
+}  // namespace lace
+#endif  // _LACE_PERSISTENT_MAP_H_
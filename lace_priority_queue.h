@@ -0,0 +1,303 @@
+#ifndef _LACE_PRIORITY_QUEUE_H_
+#define _LACE_PRIORITY_QUEUE_H_
+
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace lace {
+
+// Priority queue over a d-ary heap in one contiguous array. Like
+// std::priority_queue, top() is the greatest element under Compare. With
+// Arity children per node the heap is log_Arity(n) levels deep, so pop
+// compares more siblings per level but visits fewer levels; the siblings
+// share a cache line or two, which makes 4 a better default than 2.
+//
+// Elements are moved into a hole rather than swapped while sifting.
+template <typename T, typename Compare = std::less<T>, size_t Arity = 4>
+class priority_queue {
+  static_assert(Arity >= 2, "priority_queue needs at least two children");
+
+ public:
+  using value_type = T;
+  using reference = T&;
+  using const_reference = const T&;
+  using size_type = size_t;
+  using value_compare = Compare;
+
+  priority_queue() = default;
+  explicit priority_queue(const Compare& comp) : comp_(comp) {}
+
+  // Builds the heap bottom-up in O(n).
+  template <typename InputIt>
+  priority_queue(InputIt first, InputIt last, const Compare& comp = Compare())
+      : heap_(first, last), comp_(comp) {
+    heapify();
+  }
+
+  priority_queue(std::initializer_list<value_type> const& items,
+                 const Compare& comp = Compare())
+      : priority_queue(items.begin(), items.end(), comp) {}
+
+  const_reference top() const {
+    if (heap_.empty()) throw std::out_of_range("top on empty priority_queue");
+    return heap_.front();
+  }
+
+  void push(const_reference value) { emplace(value); }
+  void push(value_type&& value) { emplace(std::move(value)); }
+
+  template <typename... Args>
+  void emplace(Args&&... args) {
+    heap_.emplace_back(std::forward<Args>(args)...);
+    sift_up(heap_.size() - 1);
+  }
+
+  void pop() {
+    if (heap_.empty()) throw std::out_of_range("pop on empty priority_queue");
+    if (heap_.size() > 1) {
+      value_type last = std::move(heap_.back());
+      heap_.pop_back();
+      refill_root(std::move(last));
+    } else {
+      heap_.pop_back();
+    }
+  }
+
+  size_type size() const noexcept { return heap_.size(); }
+  bool empty() const noexcept { return heap_.empty(); }
+  void reserve(size_type n) { heap_.reserve(n); }
+  void clear() noexcept { heap_.clear(); }
+
+  void swap(priority_queue& other) noexcept {
+    heap_.swap(other.heap_);
+    std::swap(comp_, other.comp_);
+  }
+
+ private:
+  std::vector<value_type> heap_;
+  Compare comp_;
+
+  void heapify() {
+    if (heap_.size() < 2) return;
+    for (size_t i = (heap_.size() - 2) / Arity + 1; i-- > 0;) {
+      value_type value = std::move(heap_[i]);
+      sift_down(i, std::move(value));
+    }
+  }
+
+  void sift_up(size_t i) {
+    value_type value = std::move(heap_[i]);
+    while (i > 0) {
+      size_t parent = (i - 1) / Arity;
+      if (!comp_(heap_[parent], value)) break;
+      heap_[i] = std::move(heap_[parent]);
+      i = parent;
+    }
+    heap_[i] = std::move(value);
+  }
+
+  // Fills the hole at i with value, moving greater children up.
+  void sift_down(size_t i, value_type value) {
+    size_t size = heap_.size();
+    while (true) {
+      size_t first = i * Arity + 1;
+      if (first >= size) break;
+      size_t last = first + Arity < size ? first + Arity : size;
+      size_t best = first;
+      for (size_t child = first + 1; child < last; ++child) {
+        if (comp_(heap_[best], heap_[child])) best = child;
+      }
+      if (!comp_(value, heap_[best])) break;
+      heap_[i] = std::move(heap_[best]);
+      i = best;
+    }
+    heap_[i] = std::move(value);
+  }
+
+  // Floyd's variant of sift_down for pop: value came from the bottom and
+  // will most likely end up there, so walk the hole down along the greatest
+  // children without comparing against value, then sift value up from the
+  // leaf. That saves a comparison on every level of the way down.
+  void refill_root(value_type value) {
+    size_t size = heap_.size();
+    size_t i = 0;
+    while (true) {
+      size_t first = i * Arity + 1;
+      if (first >= size) break;
+      size_t last = first + Arity < size ? first + Arity : size;
+      size_t best = first;
+      for (size_t child = first + 1; child < last; ++child) {
+        if (comp_(heap_[best], heap_[child])) best = child;
+      }
+      heap_[i] = std::move(heap_[best]);
+      i = best;
+    }
+    while (i > 0) {
+      size_t parent = (i - 1) / Arity;
+      if (!comp_(heap_[parent], value)) break;
+      heap_[i] = std::move(heap_[parent]);
+      i = parent;
+    }
+    heap_[i] = std::move(value);
+  }
+};  // priority_queue
+
+// priority_queue whose elements can be found again through the handle
+// push() returns, to change their priority or remove them in O(log n).
+// Every move in the heap also updates a handle-to-position table. Handles of
+// popped or erased elements are reused by later pushes.
+template <typename T, typename Compare = std::less<T>, size_t Arity = 4>
+class indexed_priority_queue {
+  static_assert(Arity >= 2, "priority_queue needs at least two children");
+
+ public:
+  using value_type = T;
+  using const_reference = const T&;
+  using size_type = size_t;
+  using value_compare = Compare;
+  using handle = size_t;
+
+  indexed_priority_queue() = default;
+  explicit indexed_priority_queue(const Compare& comp) : comp_(comp) {}
+
+  const_reference top() const { return heap_.at(0).value; }
+  handle top_handle() const { return heap_.at(0).id; }
+
+  handle push(const_reference value) { return emplace(value); }
+  handle push(value_type&& value) { return emplace(std::move(value)); }
+
+  template <typename... Args>
+  handle emplace(Args&&... args) {
+    bool reused = !free_.empty();
+    handle id = reused ? free_.back() : positions_.size();
+    if (!reused) positions_.push_back(kAbsent);
+    heap_.push_back(entry{value_type(std::forward<Args>(args)...), id});
+    if (reused) free_.pop_back();
+    sift_up(heap_.size() - 1);
+    return id;
+  }
+
+  void pop() {
+    if (heap_.empty()) throw std::out_of_range("pop on empty priority_queue");
+    remove_at(0);
+  }
+
+  bool contains(handle h) const {
+    return h < positions_.size() && positions_[h] != kAbsent;
+  }
+
+  const_reference value(handle h) const { return heap_[position(h)].value; }
+
+  // Raises the priority of h: gives it a value that is not less than its
+  // current one under Compare, so it only moves towards the top. With
+  // std::greater, as in Dijkstra's algorithm, that is a smaller key.
+  void promote(handle h, value_type value) {
+    size_t i = position(h);
+    if (comp_(value, heap_[i].value)) {
+      throw std::invalid_argument("promote would lower the priority");
+    }
+    heap_[i].value = std::move(value);
+    sift_up(i);
+  }
+
+  // Changes the value of h in either direction.
+  void update(handle h, value_type value) {
+    size_t i = position(h);
+    bool rises = comp_(heap_[i].value, value);
+    heap_[i].value = std::move(value);
+    if (rises) {
+      sift_up(i);
+    } else {
+      entry e = std::move(heap_[i]);
+      sift_down(i, std::move(e));
+    }
+  }
+
+  void erase(handle h) { remove_at(position(h)); }
+
+  size_type size() const noexcept { return heap_.size(); }
+  bool empty() const noexcept { return heap_.empty(); }
+  void reserve(size_type n) {
+    heap_.reserve(n);
+    positions_.reserve(n);
+  }
+
+  void clear() noexcept {
+    heap_.clear();
+    positions_.clear();
+    free_.clear();
+  }
+
+ private:
+  static constexpr size_t kAbsent = std::numeric_limits<size_t>::max();
+
+  struct entry {
+    value_type value;
+    handle id;
+  };
+
+  std::vector<entry> heap_;
+  // Heap position of every handle, or kAbsent once it has left the heap.
+  std::vector<size_t> positions_;
+  std::vector<handle> free_;
+  Compare comp_;
+
+  size_t position(handle h) const {
+    if (!contains(h)) throw std::out_of_range("Unknown priority_queue handle");
+    return positions_[h];
+  }
+
+  void place(size_t i, entry&& e) {
+    positions_[e.id] = i;
+    heap_[i] = std::move(e);
+  }
+
+  void remove_at(size_t i) {
+    handle id = heap_[i].id;
+    entry last = std::move(heap_.back());
+    heap_.pop_back();
+    positions_[id] = kAbsent;
+    free_.push_back(id);
+    if (i == heap_.size()) return;
+    if (i > 0 && comp_(heap_[(i - 1) / Arity].value, last.value)) {
+      heap_[i] = std::move(last);
+      sift_up(i);
+    } else {
+      sift_down(i, std::move(last));
+    }
+  }
+
+  void sift_up(size_t i) {
+    entry e = std::move(heap_[i]);
+    while (i > 0) {
+      size_t parent = (i - 1) / Arity;
+      if (!comp_(heap_[parent].value, e.value)) break;
+      place(i, std::move(heap_[parent]));
+      i = parent;
+    }
+    place(i, std::move(e));
+  }
+
+  void sift_down(size_t i, entry e) {
+    size_t size = heap_.size();
+    while (true) {
+      size_t first = i * Arity + 1;
+      if (first >= size) break;
+      size_t last = first + Arity < size ? first + Arity : size;
+      size_t best = first;
+      for (size_t child = first + 1; child < last; ++child) {
+        if (comp_(heap_[best].value, heap_[child].value)) best = child;
+      }
+      if (!comp_(e.value, heap_[best].value)) break;
+      place(i, std::move(heap_[best]));
+      i = best;
+    }
+    place(i, std::move(e));
+  }
+};  // indexed_priority_queue
+}  // namespace lace
+#endif  // _LACE_PRIORITY_QUEUE_H_
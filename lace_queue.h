@@ -1,14 +1,17 @@
 #ifndef _lace_QUEUE_H_
 #define _lace_QUEUE_H_
 #include <iostream>
-#include <list>
 #include <stdexcept>
+#include <utility>
+
+#include "lace_ring_buffer.h"
+#include "lace_unrolled_list.h"
 
 // #include "lace_list.h"
 
 namespace lace {
 
-template <class T, class Container = std::list<T>>
+template <class T, class Container = ring_buffer<T>>
 
 class queue {
   Container container_;
@@ -28,6 +31,7 @@ class queue {
   queue(queue&& other) noexcept : container_(std::move(other.container_)) {}
 
   void push(const_reference tail) { container_.push_back(tail); }
+  void push(value_type&& tail) { container_.push_back(std::move(tail)); }
 
   void pop() { container_.pop_front(); }
 
@@ -51,5 +55,10 @@ class queue {
   void swap(queue& other) noexcept { container_.swap(other.container_); }
 
 };  // queue
+
+// For queues whose length swings widely: memory follows the length chunk by
+// chunk instead of staying at the peak.
+template <class T>
+using chunked_queue = queue<T, unrolled_list<T>>;
 }  // namespace lace
 #endif  // queue_H_
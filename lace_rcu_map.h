@@ -0,0 +1,138 @@
+#ifndef _LACE_RCU_MAP_H_
+#define _LACE_RCU_MAP_H_
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "lace_epoch.h"
+#include "lace_persistent_map.h"
+
+namespace lace {
+
+// Read-mostly map in the RCU style. The current contents are an immutable
+// persistent_map version published through an atomic pointer. Writers are
+// serialised by a mutex, derive a new version from the current one (sharing
+// all untouched subtrees) and publish it with a single pointer swap.
+//
+// Readers never lock and never wait: pinning a version is a pin of the map's
+// epoch domain followed by one load of the version pointer. Replaced
+// versions are retired to the domain and freed once no pinned reader can
+// still hold them.
+template <typename Key, typename T>
+class rcu_map {
+ public:
+  using version_type = persistent_map<Key, T>;
+  using size_type = size_t;
+
+  // Keeps one version alive for as long as it exists.
+  class read_guard {
+   public:
+    read_guard(const read_guard&) = delete;
+    read_guard& operator=(const read_guard&) = delete;
+    read_guard(read_guard&&) = default;
+    read_guard& operator=(read_guard&&) = delete;
+
+    const version_type& operator*() const { return *version_; }
+    const version_type* operator->() const { return version_; }
+
+   private:
+    friend class rcu_map;
+
+    read_guard(epoch::guard guard, const version_type* version)
+        : guard_(std::move(guard)), version_(version) {}
+
+    epoch::guard guard_;
+    const version_type* version_;
+  };
+
+  // Reader handle. A reader must be used by one thread at a time and must
+  // not outlive its map. Guards from the same reader may nest.
+  class reader {
+   public:
+    reader(const reader&) = delete;
+    reader& operator=(const reader&) = delete;
+    reader(reader&&) noexcept = default;
+    reader& operator=(reader&&) = delete;
+
+    read_guard pin() {
+      epoch::guard guard = owner_->domain_.pin();
+      return read_guard(std::move(guard), owner_->current_.load());
+    }
+
+   private:
+    friend class rcu_map;
+
+    explicit reader(const rcu_map* owner) : owner_(owner) {}
+
+    const rcu_map* owner_;
+  };
+
+  rcu_map() : current_(new version_type()) {}
+
+  explicit rcu_map(version_type initial)
+      : current_(new version_type(std::move(initial))) {}
+
+  rcu_map(const rcu_map&) = delete;
+  rcu_map& operator=(const rcu_map&) = delete;
+
+  // No reader may be pinned when the map is destroyed.
+  ~rcu_map() { delete current_.load(); }
+
+  reader make_reader() const { return reader(this); }
+
+  // Applies fn(version_type&) to a copy of the current version and publishes
+  // the result. Several changes made in one call become visible atomically.
+  template <typename Fn>
+  void update(Fn fn) {
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    auto next = std::make_unique<version_type>(current_.load()->snapshot());
+    fn(*next);
+    publish(next.release());
+  }
+
+  bool insert(const Key& key, const T& value) {
+    bool inserted = false;
+    update([&](version_type& v) { inserted = v.insert(key, value); });
+    return inserted;
+  }
+
+  bool insert_or_assign(const Key& key, const T& value) {
+    bool inserted = false;
+    update([&](version_type& v) {
+      inserted = v.insert_or_assign(key, value);
+    });
+    return inserted;
+  }
+
+  bool erase(const Key& key) {
+    bool erased = false;
+    update([&](version_type& v) { erased = v.erase(key); });
+    return erased;
+  }
+
+  void clear() {
+    update([](version_type& v) { v.clear(); });
+  }
+
+  // Versions waiting for readers to move on.
+  size_type retired_count() const { return domain_.garbage_size(); }
+
+  // Frees every version retired by the calling thread that no pinned reader
+  // can still see.
+  void reclaim() { domain_.reclaim(); }
+
+ private:
+  std::atomic<const version_type*> current_;
+  mutable std::mutex writer_mutex_;
+  mutable epoch domain_;
+
+  void publish(const version_type* next) {
+    domain_.retire(current_.exchange(next));
+    domain_.reclaim();
+  }
+
+};  // rcu_map
+}  // namespace lace
+#endif  // _LACE_RCU_MAP_H_
@@ -0,0 +1,187 @@
+#ifndef _LACE_RING_BUFFER_H_
+#define _LACE_RING_BUFFER_H_
+
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace lace {
+
+// Growable circular buffer. Elements live inline in one contiguous
+// allocation whose capacity is a power of two, so positions wrap with a mask
+// and pushing or popping at either end costs no allocation once the buffer
+// has grown to its working size. Growing doubles the capacity and moves the
+// elements to the front of the new block.
+//
+// Provides the push_back/pop_front/front/back interface lace::queue expects
+// of its container.
+template <typename T>
+class ring_buffer {
+ public:
+  using value_type = T;
+  using reference = T&;
+  using const_reference = const T&;
+  using size_type = size_t;
+
+  static constexpr size_type kMinCapacity = 8;
+
+  ring_buffer() noexcept = default;
+
+  // Delegating to the default constructor makes the buffer fully
+  // constructed before the first copy, so the destructor frees the copies
+  // made so far if a later one throws.
+  ring_buffer(std::initializer_list<value_type> const& items) : ring_buffer() {
+    reserve(items.size());
+    for (const auto& item : items) push_back(item);
+  }
+
+  ring_buffer(const ring_buffer& other) : ring_buffer() {
+    reserve(other.size_);
+    for (size_type i = 0; i < other.size_; ++i) push_back(other[i]);
+  }
+
+  ring_buffer(ring_buffer&& other) noexcept { swap(other); }
+
+  ring_buffer& operator=(ring_buffer other) noexcept {
+    swap(other);
+    return *this;
+  }
+
+  ~ring_buffer() {
+    clear();
+    if (data_ != nullptr) allocator().deallocate(data_, capacity_);
+  }
+
+  void push_back(const_reference value) { emplace_back(value); }
+  void push_back(value_type&& value) { emplace_back(std::move(value)); }
+
+  template <typename... Args>
+  reference emplace_back(Args&&... args) {
+    if (size_ == capacity_ && sizeof...(Args) > 0) {
+      // The new element is built first: args may refer into this buffer.
+      grow(capacity_ == 0 ? kMinCapacity : 2 * capacity_,
+           std::forward<Args>(args)...);
+    } else {
+      if (size_ == capacity_) reserve(size_ + 1);
+      new (slot(size_)) value_type(std::forward<Args>(args)...);
+    }
+    return (*this)[size_++];
+  }
+
+  void pop_front() {
+    if (size_ == 0) throw std::out_of_range("pop_front on empty ring_buffer");
+    data_[head_].~value_type();
+    head_ = (head_ + 1) & (capacity_ - 1);
+    --size_;
+  }
+
+  reference front() { return checked(0); }
+  const_reference front() const { return checked(0); }
+  reference back() { return checked(size_ - 1); }
+  const_reference back() const { return checked(size_ - 1); }
+
+  // Position i counts from the front.
+  reference operator[](size_type i) { return *slot(i); }
+  const_reference operator[](size_type i) const { return *slot(i); }
+
+  reference at(size_type i) {
+    if (i >= size_) throw std::out_of_range("Index out of range");
+    return *slot(i);
+  }
+  const_reference at(size_type i) const {
+    if (i >= size_) throw std::out_of_range("Index out of range");
+    return *slot(i);
+  }
+
+  size_type size() const noexcept { return size_; }
+  bool empty() const noexcept { return size_ == 0; }
+  size_type capacity() const noexcept { return capacity_; }
+
+  // Largest power of two the allocator can provide.
+  size_type max_size() const noexcept {
+    size_type limit =
+        std::allocator_traits<std::allocator<value_type>>::max_size(
+            allocator());
+    size_type capacity = 1;
+    while (capacity <= limit / 2) capacity *= 2;
+    return capacity;
+  }
+
+  // Rounds the capacity up to a power of two that holds at least n elements.
+  // Throws std::length_error when n exceeds max_size().
+  void reserve(size_type n) {
+    if (n <= capacity_) return;
+    if (n > max_size()) throw std::length_error("ring_buffer::reserve");
+    size_type capacity = capacity_ == 0 ? kMinCapacity : capacity_;
+    while (capacity < n) capacity *= 2;
+    grow(capacity);
+  }
+
+  void clear() noexcept {
+    for (size_type i = 0; i < size_; ++i) slot(i)->~value_type();
+    head_ = 0;
+    size_ = 0;
+  }
+
+  void swap(ring_buffer& other) noexcept {
+    std::swap(data_, other.data_);
+    std::swap(capacity_, other.capacity_);
+    std::swap(head_, other.head_);
+    std::swap(size_, other.size_);
+  }
+
+ private:
+  value_type* data_ = nullptr;
+  size_type capacity_ = 0;
+  size_type head_ = 0;
+  size_type size_ = 0;
+
+  static std::allocator<value_type> allocator() { return {}; }
+
+  value_type* slot(size_type i) {
+    return data_ + ((head_ + i) & (capacity_ - 1));
+  }
+  const value_type* slot(size_type i) const {
+    return data_ + ((head_ + i) & (capacity_ - 1));
+  }
+
+  reference checked(size_type i) {
+    if (size_ == 0) throw std::out_of_range("Accessing empty ring_buffer");
+    return *slot(i);
+  }
+  const_reference checked(size_type i) const {
+    if (size_ == 0) throw std::out_of_range("Accessing empty ring_buffer");
+    return *slot(i);
+  }
+
+  // Moves the elements to the front of a block of the given capacity. With
+  // args, also constructs a new element right after them.
+  template <typename... Args>
+  void grow(size_type capacity, Args&&... args) {
+    value_type* data = allocator().allocate(capacity);
+    size_type moved = 0;
+    bool built = false;
+    try {
+      if constexpr (sizeof...(Args) > 0) {
+        new (data + size_) value_type(std::forward<Args>(args)...);
+        built = true;
+      }
+      for (; moved < size_; ++moved) {
+        new (data + moved) value_type(std::move_if_noexcept(*slot(moved)));
+      }
+    } catch (...) {
+      for (size_type i = 0; i < moved; ++i) data[i].~value_type();
+      if (built) data[size_].~value_type();
+      allocator().deallocate(data, capacity);
+      throw;
+    }
+    for (size_type i = 0; i < size_; ++i) slot(i)->~value_type();
+    if (data_ != nullptr) allocator().deallocate(data_, capacity_);
+    data_ = data;
+    capacity_ = capacity;
+    head_ = 0;
+  }
+};  // ring_buffer
+}  // namespace lace
+#endif  // _LACE_RING_BUFFER_H_
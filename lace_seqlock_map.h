@@ -0,0 +1,387 @@
+#ifndef _LACE_SEQLOCK_MAP_H_
+#define _LACE_SEQLOCK_MAP_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "lace_epoch.h"
+#include "lace_map.h"
+
+namespace lace {
+
+// Ordered map for one writer and many readers. The writer changes an AVL
+// tree in place and brackets every change with two increments of a sequence
+// counter. Readers take no lock: they note the counter, walk the tree, and
+// retry if the counter was odd or has moved. A reader therefore writes only
+// its own epoch slot, never a line the writer or other readers touch.
+//
+// Erased nodes are retired to an epoch domain rather than deleted, so a
+// reader that is half way down a stale path never follows a dangling
+// left/right pointer. A reader that keeps losing to the writer falls back to
+// the writer lock after a few attempts, so reads always finish.
+//
+// Writers are serialised by a mutex and may run on any thread. Keys and
+// values are copied out of nodes under validation, so both must be trivially
+// copyable.
+template <typename Key, typename T>
+class seqlock_map {
+  static_assert(std::is_trivially_copyable_v<Key> &&
+                    std::is_trivially_copyable_v<T>,
+                "seqlock_map needs trivially copyable keys and values");
+
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<const Key, T>;
+  using size_type = size_t;
+
+ private:
+  static constexpr int kOptimisticAttempts = 16;
+  // Deeper than any AVL tree that fits in memory; a longer walk can only be
+  // a reader racing with a rotation.
+  static constexpr int kMaxDepth = 96;
+
+  struct Node {
+    std::atomic<Key> key;
+    std::atomic<T> value;
+    std::atomic<Node*> left{nullptr};
+    std::atomic<Node*> right{nullptr};
+    int height = 1;
+
+    Node(const Key& k, const T& v) : key(k), value(v) {}
+  };
+
+ public:
+  seqlock_map() = default;
+
+  seqlock_map(std::initializer_list<std::pair<Key, T>> init_list) {
+    for (const auto& item : init_list) insert(item.first, item.second);
+  }
+
+  seqlock_map(const seqlock_map&) = delete;
+  seqlock_map& operator=(const seqlock_map&) = delete;
+
+  // No reader may be running when the map is destroyed.
+  ~seqlock_map() { destroy(root_.load()); }
+
+  size_type size() const { return size_.load(std::memory_order_relaxed); }
+  bool empty() const { return size() == 0; }
+
+  bool insert(const Key& key, const T& value) {
+    return write([&] { return insert_at(root_, key, value, false); });
+  }
+
+  // Returns true if the key was inserted, false if its value was replaced.
+  bool insert_or_assign(const Key& key, const T& value) {
+    return write([&] { return insert_at(root_, key, value, true); });
+  }
+
+  bool erase(const Key& key) {
+    Node* removed = nullptr;
+    write([&] { return erase_at(root_, key, removed); });
+    if (removed == nullptr) return false;
+    domain_.retire(removed);
+    return true;
+  }
+
+  void clear() {
+    std::vector<Node*> removed;
+    write([&] {
+      collect_nodes(root_.load(std::memory_order_relaxed), removed);
+      root_.store(nullptr, std::memory_order_release);
+      size_.store(0, std::memory_order_relaxed);
+      return true;
+    });
+    for (Node* node : removed) domain_.retire(node);
+  }
+
+  bool contains(const Key& key) const { return get(key).has_value(); }
+
+  // Returns a copy of the value, or nothing if the key is absent.
+  std::optional<T> get(const Key& key) const {
+    return read([&](bool& valid) {
+      std::optional<T> result;
+      const Node* node = root_.load(std::memory_order_acquire);
+      for (int depth = 0; node != nullptr; ++depth) {
+        if (depth == kMaxDepth) {
+          valid = false;
+          break;
+        }
+        Key k = node->key.load(std::memory_order_relaxed);
+        if (key < k) {
+          node = node->left.load(std::memory_order_acquire);
+        } else if (k < key) {
+          node = node->right.load(std::memory_order_acquire);
+        } else {
+          result = node->value.load(std::memory_order_relaxed);
+          break;
+        }
+      }
+      return result;
+    });
+  }
+
+  T at(const Key& key) const {
+    std::optional<T> value = get(key);
+    if (!value) throw std::out_of_range("Key not found");
+    return *value;
+  }
+
+  // Copies the entries in [lo, hi) in one consistent read, then calls
+  // fn(const value_type&) on each in order; fn may return false to stop.
+  template <typename Fn>
+  void for_each_in_range(const Key& lo, const Key& hi, Fn fn) const {
+    std::vector<value_type> items = read([&](bool& valid) {
+      std::vector<value_type> out;
+      valid = collect_range(&lo, &hi, out);
+      return out;
+    });
+    for (const value_type& kv : items) {
+      if (!detail::call_visitor(fn, kv)) return;
+    }
+  }
+
+  // Copies the whole map into a lace::map in one consistent read.
+  map<Key, T> to_map() const {
+    std::vector<value_type> items = read([&](bool& valid) {
+      std::vector<value_type> out;
+      valid = collect_range(nullptr, nullptr, out);
+      return out;
+    });
+    return map<Key, T>::from_sorted(items.begin(), items.end());
+  }
+
+  bool is_balanced() const {
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    return check_balance(root_.load(std::memory_order_relaxed)) >= 0;
+  }
+
+ private:
+  std::atomic<Node*> root_{nullptr};
+  std::atomic<size_type> size_{0};
+  alignas(64) std::atomic<uint64_t> sequence_{0};
+  mutable std::mutex writer_mutex_;
+  mutable epoch domain_;
+
+  // The release fence orders the odd counter before the tree stores, so a
+  // reader that sees any of them also sees the counter move.
+  template <typename Fn>
+  bool write(Fn fn) {
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    sequence_.store(sequence_.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bool result = fn();
+    sequence_.store(sequence_.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_release);
+    return result;
+  }
+
+  // Runs fn(valid) until it completes without overlapping a write; fn clears
+  // valid when it notices an inconsistent tree.
+  template <typename Fn>
+  auto read(Fn fn) const {
+    auto guard = domain_.pin();
+    for (int attempt = 0; attempt < kOptimisticAttempts; ++attempt) {
+      uint64_t sequence = sequence_.load(std::memory_order_acquire);
+      if (sequence & 1) {
+        std::this_thread::yield();
+        continue;
+      }
+      bool valid = true;
+      auto result = fn(valid);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (valid && sequence_.load(std::memory_order_relaxed) == sequence) {
+        return result;
+      }
+    }
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    bool valid = true;
+    return fn(valid);
+  }
+
+  // In-order walk of [lo, hi); null bounds are open. Returns false if the
+  // walk went deeper than any consistent tree can be.
+  bool collect_range(const Key* lo, const Key* hi,
+                     std::vector<value_type>& out) const {
+    const Node* stack[kMaxDepth];
+    int depth = 0;
+    const Node* node = root_.load(std::memory_order_acquire);
+    while (node != nullptr || depth > 0) {
+      while (node != nullptr) {
+        if (depth == kMaxDepth) return false;
+        Key k = node->key.load(std::memory_order_relaxed);
+        if (lo != nullptr && k < *lo) {
+          node = node->right.load(std::memory_order_acquire);
+        } else {
+          stack[depth++] = node;
+          node = node->left.load(std::memory_order_acquire);
+        }
+      }
+      if (depth == 0) break;
+      node = stack[--depth];
+      Key k = node->key.load(std::memory_order_relaxed);
+      if (hi != nullptr && !(k < *hi)) break;
+      out.emplace_back(k, node->value.load(std::memory_order_relaxed));
+      node = node->right.load(std::memory_order_acquire);
+    }
+    return true;
+  }
+
+  static int height_of(const Node* node) { return node ? node->height : 0; }
+
+  static Node* child(const std::atomic<Node*>& link) {
+    return link.load(std::memory_order_relaxed);
+  }
+
+  // Stores only real changes, so readers see as few writes as possible.
+  static void set(std::atomic<Node*>& link, Node* node) {
+    if (link.load(std::memory_order_relaxed) != node) {
+      link.store(node, std::memory_order_release);
+    }
+  }
+
+  static void update_height(Node* node) {
+    node->height = 1 + std::max(height_of(child(node->left)),
+                                height_of(child(node->right)));
+  }
+
+  // Each rotation detaches the inner grandchild before relinking, so the
+  // nodes never form a cycle, even for a moment.
+  static Node* rotate_right(Node* node) {
+    Node* pivot = child(node->left);
+    set(node->left, child(pivot->right));
+    set(pivot->right, node);
+    update_height(node);
+    update_height(pivot);
+    return pivot;
+  }
+
+  static Node* rotate_left(Node* node) {
+    Node* pivot = child(node->right);
+    set(node->right, child(pivot->left));
+    set(pivot->left, node);
+    update_height(node);
+    update_height(pivot);
+    return pivot;
+  }
+
+  static Node* balance(Node* node) {
+    update_height(node);
+    int diff = height_of(child(node->left)) - height_of(child(node->right));
+    if (diff > 1) {
+      Node* left = child(node->left);
+      if (height_of(child(left->left)) < height_of(child(left->right))) {
+        set(node->left, rotate_left(left));
+      }
+      return rotate_right(node);
+    }
+    if (diff < -1) {
+      Node* right = child(node->right);
+      if (height_of(child(right->right)) < height_of(child(right->left))) {
+        set(node->right, rotate_right(right));
+      }
+      return rotate_left(node);
+    }
+    return node;
+  }
+
+  bool insert_at(std::atomic<Node*>& link, const Key& key, const T& value,
+                 bool assign) {
+    Node* node = child(link);
+    if (node == nullptr) {
+      link.store(new Node(key, value), std::memory_order_release);
+      size_.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+    Key k = node->key.load(std::memory_order_relaxed);
+    bool inserted;
+    if (key < k) {
+      inserted = insert_at(node->left, key, value, assign);
+    } else if (k < key) {
+      inserted = insert_at(node->right, key, value, assign);
+    } else {
+      if (assign) node->value.store(value, std::memory_order_relaxed);
+      return false;
+    }
+    if (inserted) set(link, balance(node));
+    return inserted;
+  }
+
+  static Node* detach_min(std::atomic<Node*>& link) {
+    Node* node = child(link);
+    if (child(node->left) == nullptr) {
+      set(link, child(node->right));
+      return node;
+    }
+    Node* min = detach_min(node->left);
+    set(link, balance(node));
+    return min;
+  }
+
+  // Unlinks the node holding key and hands it back through removed. A node
+  // with two children takes over its successor's entry and the successor
+  // node is the one removed.
+  bool erase_at(std::atomic<Node*>& link, const Key& key, Node*& removed) {
+    Node* node = child(link);
+    if (node == nullptr) return false;
+    Key k = node->key.load(std::memory_order_relaxed);
+    if (key < k) {
+      if (!erase_at(node->left, key, removed)) return false;
+    } else if (k < key) {
+      if (!erase_at(node->right, key, removed)) return false;
+    } else {
+      size_.fetch_sub(1, std::memory_order_relaxed);
+      if (child(node->left) == nullptr || child(node->right) == nullptr) {
+        Node* only = child(node->left) ? child(node->left) : child(node->right);
+        set(link, only);
+        removed = node;
+        return true;
+      }
+      Node* successor = detach_min(node->right);
+      node->key.store(successor->key.load(std::memory_order_relaxed),
+                      std::memory_order_relaxed);
+      node->value.store(successor->value.load(std::memory_order_relaxed),
+                        std::memory_order_relaxed);
+      removed = successor;
+    }
+    set(link, balance(node));
+    return true;
+  }
+
+  static void collect_nodes(Node* node, std::vector<Node*>& out) {
+    if (node == nullptr) return;
+    out.push_back(node);
+    collect_nodes(child(node->left), out);
+    collect_nodes(child(node->right), out);
+  }
+
+  static void destroy(Node* node) {
+    if (node == nullptr) return;
+    destroy(child(node->left));
+    destroy(child(node->right));
+    delete node;
+  }
+
+  static int check_balance(const Node* node) {
+    if (node == nullptr) return 0;
+    int left = check_balance(child(node->left));
+    int right = check_balance(child(node->right));
+    if (left < 0 || right < 0 || left - right > 1 || right - left > 1 ||
+        node->height != 1 + std::max(left, right)) {
+      return -1;
+    }
+    return node->height;
+  }
+
+};  // seqlock_map
+}  // namespace lace
+#endif  // _LACE_SEQLOCK_MAP_H_
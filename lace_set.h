@@ -1,6 +1,9 @@
 #ifndef _lace_SET_H_
 #define _lace_SET_H_
 
+#include <iterator>
+#include <vector>
+
 #include "lace_map.h"
 
 namespace lace {
@@ -21,7 +24,7 @@ class set {
    public:
     iterator(tree_iterator it) : it_(it) {}
 
-    value_type operator*() const { return it_->first; }
+    const value_type& operator*() const { return it_->first; }
     const value_type* operator->() const { return &it_->first; }
 
     iterator& operator++() {
@@ -58,7 +61,7 @@ class set {
     const_iterator(tree_const_iterator it) : it_(it) {}
     const_iterator(iterator it) : it_(it.base()) {}
 
-    value_type operator*() const { return (*it_).first; }
+    const value_type& operator*() const { return (*it_).first; }
     const value_type* operator->() const { return &it_->first; }
 
     const_iterator& operator++() {
@@ -152,6 +155,52 @@ class set {
   }
   bool contains(const key_type& key) const { return tree_.contains(key); }
 
+  iterator lower_bound_from(const iterator& from, const key_type& key) {
+    return iterator(tree_.lower_bound_from(from.base(), key));
+  }
+  const_iterator lower_bound_from(const const_iterator& from,
+                                  const key_type& key) const {
+    return const_iterator(tree_.lower_bound_from(from.base(), key));
+  }
+
+  iterator find_from(const iterator& from, const key_type& key) {
+    return iterator(tree_.find_from(from.base(), key));
+  }
+  const_iterator find_from(const const_iterator& from,
+                           const key_type& key) const {
+    return const_iterator(tree_.find_from(from.base(), key));
+  }
+
+  iterator insert(const iterator& hint, const value_type& value) {
+    return iterator(tree_.insert(hint.base(), {value, char()}));
+  }
+
+  template <typename Fn>
+  void for_each_in_range(const key_type& lo, const key_type& hi,
+                         Fn fn) const {
+    tree_.for_each_in_range(lo, hi, [&fn](const auto& kv) {
+      return detail::call_visitor(fn, kv.first);
+    });
+  }
+
+  std::vector<const_iterator> split(size_t parts) const {
+    auto tree_bounds = tree_.split(parts);
+    return std::vector<const_iterator>(tree_bounds.begin(), tree_bounds.end());
+  }
+
+  // Builds a set in O(n) from strictly increasing keys, with the subtrees
+  // built where the builder policy says (see map::from_sorted).
+  template <typename Builder = detail::sequential_build>
+  static set from_sorted(std::vector<Key> keys,
+                         const Builder& builder = Builder()) {
+    std::vector<std::pair<Key, char>> items;
+    items.reserve(keys.size());
+    for (auto& key : keys) items.emplace_back(std::move(key), char());
+    set result;
+    result.tree_ = map<Key, char>::from_sorted(std::move(items), builder);
+    return result;
+  }
+
   template <typename... Args>
   std::vector<std::pair<iterator, bool>> insert_many(Args&&... args) {
     static_assert((std::is_convertible_v<Args, Key> && ...),
@@ -165,6 +214,71 @@ class set {
   }
 };
 
+namespace detail {
+
+// Which keys a merge walk keeps: those only in the left input, only in the
+// right one, or in both.
+enum merge_keep : unsigned { kLeftOnly = 1, kRightOnly = 2, kBoth = 4 };
+
+template <typename It, typename Key>
+void merge_walk(It left, It left_last, It right, It right_last, unsigned keep,
+                std::vector<Key>& out) {
+  while (left != left_last && right != right_last) {
+    if (*left < *right) {
+      if (keep & kLeftOnly) out.push_back(*left);
+      ++left;
+    } else if (*right < *left) {
+      if (keep & kRightOnly) out.push_back(*right);
+      ++right;
+    } else {
+      if (keep & kBoth) out.push_back(*left);
+      ++left;
+      ++right;
+    }
+  }
+  for (; (keep & kLeftOnly) && left != left_last; ++left) {
+    out.push_back(*left);
+  }
+  for (; (keep & kRightOnly) && right != right_last; ++right) {
+    out.push_back(*right);
+  }
+}
+
+// Merges both sets in one pass and bulk-builds the result.
+template <typename Key>
+set<Key> merge_sets(const set<Key>& left, const set<Key>& right,
+                    unsigned keep) {
+  std::vector<Key> keys;
+  merge_walk(left.begin(), left.end(), right.begin(), right.end(), keep, keys);
+  return set<Key>::from_sorted(std::move(keys));
+}
+
+}  // namespace detail
+
+// Set algebra as linear merge walks, O(n + m) instead of probing one set
+// with find. lace_parallel.h adds overloads taking a thread count.
+template <typename Key>
+set<Key> set_union(const set<Key>& left, const set<Key>& right) {
+  return detail::merge_sets(
+      left, right, detail::kLeftOnly | detail::kRightOnly | detail::kBoth);
+}
+
+template <typename Key>
+set<Key> set_intersection(const set<Key>& left, const set<Key>& right) {
+  return detail::merge_sets(left, right, detail::kBoth);
+}
+
+template <typename Key>
+set<Key> set_difference(const set<Key>& left, const set<Key>& right) {
+  return detail::merge_sets(left, right, detail::kLeftOnly);
+}
+
+template <typename Key>
+set<Key> symmetric_difference(const set<Key>& left, const set<Key>& right) {
+  return detail::merge_sets(left, right,
+                            detail::kLeftOnly | detail::kRightOnly);
+}
+
 }  // namespace lace
 
 #endif  // _lace_SET_H_
\ No newline at end of file
@@ -0,0 +1,304 @@
+#ifndef _LACE_SHARDED_MAP_H_
+#define _LACE_SHARDED_MAP_H_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <vector>
+
+#include "lace_map.h"
+
+namespace lace {
+
+// Lock-striped concurrent map. Keys are hashed onto Shards independent
+// lace::map instances, each guarded by its own reader-writer lock, so threads
+// working on different shards never contend. Every member function is safe to
+// call concurrently.
+template <typename Key, typename T, size_t Shards = 16,
+          typename Hash = std::hash<Key>>
+class sharded_map {
+  static_assert(Shards > 0, "sharded_map needs at least one shard");
+
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using map_type = map<Key, T>;
+  using value_type = typename map_type::value_type;
+  using size_type = size_t;
+
+ private:
+  struct alignas(64) shard {
+    mutable std::shared_mutex mutex;
+    map_type data;
+  };
+
+ public:
+  // Ordered, read-only view over all shards. It holds a shared lock on every
+  // shard for its whole lifetime, so writers block until it is destroyed.
+  // The thread owning the view must not call any member of the map while
+  // the view is alive, not even a reader: taking a shared lock it already
+  // holds is undefined behaviour and deadlocks once a writer is queued on
+  // that shard. Use the view's own lookups instead, which run under the
+  // locks it holds.
+  class ordered_view {
+   public:
+    class const_iterator {
+      using shard_iterator = typename map_type::const_iterator;
+      using cursor = std::pair<shard_iterator, shard_iterator>;
+
+     public:
+      const value_type& operator*() const {
+        if (heap_.empty()) {
+          throw std::runtime_error("Dereferencing end iterator");
+        }
+        return *heap_.front().first;
+      }
+
+      const value_type* operator->() const { return &**this; }
+
+      const_iterator& operator++() {
+        if (heap_.empty()) {
+          throw std::runtime_error("Incrementing an end iterator");
+        }
+        std::pop_heap(heap_.begin(), heap_.end(), cursor_greater);
+        if (++heap_.back().first == heap_.back().second) {
+          heap_.pop_back();
+        } else {
+          std::push_heap(heap_.begin(), heap_.end(), cursor_greater);
+        }
+        return *this;
+      }
+
+      const_iterator operator++(int) {
+        const_iterator temp = *this;
+        ++(*this);
+        return temp;
+      }
+
+      bool operator==(const const_iterator& other) const {
+        if (heap_.empty() || other.heap_.empty()) {
+          return heap_.empty() && other.heap_.empty();
+        }
+        return heap_.front().first == other.heap_.front().first;
+      }
+
+      bool operator!=(const const_iterator& other) const {
+        return !(*this == other);
+      }
+
+     private:
+      friend class ordered_view;
+
+      std::vector<cursor> heap_;
+
+      static bool cursor_greater(const cursor& a, const cursor& b) {
+        return b.first->first < a.first->first;
+      }
+    };
+
+    const_iterator begin() const {
+      const_iterator it;
+      for (const shard& s : owner_->shards_) {
+        if (!s.data.empty()) {
+          it.heap_.emplace_back(s.data.begin(), s.data.end());
+        }
+      }
+      std::make_heap(it.heap_.begin(), it.heap_.end(),
+                     const_iterator::cursor_greater);
+      return it;
+    }
+    const_iterator end() const { return const_iterator(); }
+
+    bool contains(const Key& key) const {
+      return owner_->shard_for(key).data.contains(key);
+    }
+
+    std::optional<T> get(const Key& key) const {
+      const map_type& data = owner_->shard_for(key).data;
+      auto it = data.find(key);
+      if (it == data.end()) return std::nullopt;
+      return it->second;
+    }
+
+    size_type size() const {
+      size_type total = 0;
+      for (const shard& s : owner_->shards_) total += s.data.size();
+      return total;
+    }
+
+    bool empty() const { return size() == 0; }
+
+   private:
+    friend class sharded_map;
+
+    const sharded_map* owner_;
+    std::vector<std::shared_lock<std::shared_mutex>> locks_;
+
+    explicit ordered_view(const sharded_map* owner) : owner_(owner) {
+      locks_.reserve(Shards);
+      for (const shard& s : owner_->shards_) locks_.emplace_back(s.mutex);
+    }
+  };
+
+  sharded_map() = default;
+  sharded_map(const sharded_map&) = delete;
+  sharded_map& operator=(const sharded_map&) = delete;
+  ~sharded_map() = default;
+
+  static constexpr size_type shard_count() { return Shards; }
+
+  size_type shard_of(const Key& key) const {
+    uint64_t h = static_cast<uint64_t>(hash_(key));
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return static_cast<size_type>(h % Shards);
+  }
+
+  bool insert(const Key& key, const T& value) {
+    shard& s = shards_[shard_of(key)];
+    std::unique_lock<std::shared_mutex> lock(s.mutex);
+    return s.data.insert(key, value).second;
+  }
+
+  bool insert_or_assign(const Key& key, const T& value) {
+    shard& s = shards_[shard_of(key)];
+    std::unique_lock<std::shared_mutex> lock(s.mutex);
+    return s.data.insert_or_assign(key, value).second;
+  }
+
+  bool erase(const Key& key) {
+    shard& s = shards_[shard_of(key)];
+    std::unique_lock<std::shared_mutex> lock(s.mutex);
+    if (!s.data.contains(key)) return false;
+    s.data.erase(key);
+    return true;
+  }
+
+  bool contains(const Key& key) const {
+    const shard& s = shards_[shard_of(key)];
+    std::shared_lock<std::shared_mutex> lock(s.mutex);
+    return s.data.contains(key);
+  }
+
+  std::optional<T> get(const Key& key) const {
+    const shard& s = shards_[shard_of(key)];
+    std::shared_lock<std::shared_mutex> lock(s.mutex);
+    auto it = s.data.find(key);
+    if (it == s.data.end()) return std::nullopt;
+    return it->second;
+  }
+
+  // Calls fn(const T&) under the shard's shared lock; returns false if the
+  // key is absent.
+  template <typename Fn>
+  bool visit(const Key& key, Fn fn) const {
+    const shard& s = shards_[shard_of(key)];
+    std::shared_lock<std::shared_mutex> lock(s.mutex);
+    auto it = s.data.find(key);
+    if (it == s.data.end()) return false;
+    fn(it->second);
+    return true;
+  }
+
+  // Calls fn(T&) under the shard's exclusive lock; returns false if the key
+  // is absent.
+  template <typename Fn>
+  bool update(const Key& key, Fn fn) {
+    shard& s = shards_[shard_of(key)];
+    std::unique_lock<std::shared_mutex> lock(s.mutex);
+    auto it = s.data.find(key);
+    if (it == s.data.end()) return false;
+    fn(it->second);
+    return true;
+  }
+
+  // Inserts a range of key/value pairs taking each shard's lock only once.
+  // Returns the number of keys that were not present before.
+  template <typename InputIt>
+  size_type insert_batch(InputIt first, InputIt last) {
+    std::array<std::vector<InputIt>, Shards> buckets;
+    for (; first != last; ++first) {
+      buckets[shard_of(first->first)].push_back(first);
+    }
+    size_type inserted = 0;
+    for (size_type i = 0; i < Shards; ++i) {
+      if (buckets[i].empty()) continue;
+      std::unique_lock<std::shared_mutex> lock(shards_[i].mutex);
+      for (const InputIt& it : buckets[i]) {
+        if (shards_[i].data.insert(it->first, it->second).second) inserted++;
+      }
+    }
+    return inserted;
+  }
+
+  // Erases a range of keys taking each shard's lock only once. Returns the
+  // number of keys removed.
+  template <typename InputIt>
+  size_type erase_batch(InputIt first, InputIt last) {
+    std::array<std::vector<InputIt>, Shards> buckets;
+    for (; first != last; ++first) buckets[shard_of(*first)].push_back(first);
+    size_type erased = 0;
+    for (size_type i = 0; i < Shards; ++i) {
+      if (buckets[i].empty()) continue;
+      std::unique_lock<std::shared_mutex> lock(shards_[i].mutex);
+      for (const InputIt& it : buckets[i]) {
+        if (shards_[i].data.contains(*it)) {
+          shards_[i].data.erase(*it);
+          erased++;
+        }
+      }
+    }
+    return erased;
+  }
+
+  // Runs fn(map_type&) with exclusive access to one shard.
+  template <typename Fn>
+  void with_shard(size_type index, Fn fn) {
+    shard& s = shards_.at(index);
+    std::unique_lock<std::shared_mutex> lock(s.mutex);
+    fn(s.data);
+  }
+
+  // Runs fn(const map_type&) with shared access to one shard.
+  template <typename Fn>
+  void with_shard(size_type index, Fn fn) const {
+    const shard& s = shards_.at(index);
+    std::shared_lock<std::shared_mutex> lock(s.mutex);
+    fn(s.data);
+  }
+
+  ordered_view ordered() const { return ordered_view(this); }
+
+  size_type size() const {
+    size_type total = 0;
+    for (const shard& s : shards_) {
+      std::shared_lock<std::shared_mutex> lock(s.mutex);
+      total += s.data.size();
+    }
+    return total;
+  }
+
+  bool empty() const { return size() == 0; }
+
+  void clear() {
+    for (shard& s : shards_) {
+      std::unique_lock<std::shared_mutex> lock(s.mutex);
+      s.data.clear();
+    }
+  }
+
+ private:
+  std::array<shard, Shards> shards_;
+  Hash hash_;
+
+  const shard& shard_for(const Key& key) const {
+    return shards_[shard_of(key)];
+  }
+};  // sharded_map
+}  // namespace lace
+#endif  // _LACE_SHARDED_MAP_H_
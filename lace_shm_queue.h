@@ -0,0 +1,304 @@
+#ifndef _LACE_SHM_QUEUE_H_
+#define _LACE_SHM_QUEUE_H_
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace lace {
+
+// Bounded queue between processes on one machine, stored in a POSIX
+// shared-memory object (a file under /dev/shm) that every process maps. The
+// segment holds a header with the head and tail counters, each on its own
+// cache line, followed by a power-of-two ring of slots. It contains indices
+// only, never pointers, so each process may map it at a different address.
+//
+// With MultiProducer = false, one producer and one consumer process; each
+// side keeps a private copy of the other side's counter, as
+// lace::spsc_queue does. With MultiProducer = true, any number of producers
+// claim slots with a CAS on the tail and publish them through per-slot
+// sequence numbers, as lace::mpmc_queue does; there is still one consumer.
+//
+// Values are copied in and out of the segment, so T must be trivially
+// copyable. The creator owns the name: unlink() removes it, and the memory
+// goes away once every process has unmapped it.
+//
+// Nothing recovers from a process dying mid-operation. In particular, a
+// producer that dies between claiming a slot with the tail CAS and storing
+// its sequence leaves that slot unpublished forever, and the consumer never
+// gets past it.
+template <typename T, bool MultiProducer = false>
+class shm_queue {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "shm_queue needs trivially copyable elements");
+  static_assert(std::atomic<uint64_t>::is_always_lock_free,
+                "shm_queue needs lock-free 64-bit atomics");
+
+ public:
+  using value_type = T;
+  using size_type = size_t;
+
+  // Creates and maps a new segment called name, which must start with '/'.
+  // The capacity is rounded up to a power of two, and to at least 2. Throws
+  // std::length_error if the rounded-up segment size would not fit in
+  // size_t, and std::system_error if the name exists or the segment cannot
+  // be mapped.
+  static shm_queue create(const std::string& name, size_type capacity) {
+    if (capacity > max_slots()) {
+      throw std::length_error("shm_queue capacity too large");
+    }
+    uint64_t slots = 2;
+    while (slots < capacity) slots *= 2;
+    int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) fail("shm_open");
+    size_t bytes = segment_size(slots);
+    if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+      int error = errno;
+      ::close(fd);
+      ::shm_unlink(name.c_str());
+      errno = error;
+      fail("ftruncate");
+    }
+    void* memory;
+    try {
+      memory = map(fd, bytes);
+    } catch (...) {
+      ::shm_unlink(name.c_str());
+      throw;
+    }
+    shm_queue q(memory, bytes);
+    header* h = new (q.header_) header;
+    h->capacity = slots;
+    h->value_size = sizeof(value_type);
+    h->multi_producer = MultiProducer;
+    q.attach();
+    if constexpr (MultiProducer) {
+      for (uint64_t i = 0; i < slots; ++i) {
+        new (&q.slots_[i]) slot;
+        q.slots_[i].sequence.store(i, std::memory_order_relaxed);
+      }
+    }
+    // Published last: open() refuses the segment until it sees this.
+    h->magic.store(kMagic, std::memory_order_release);
+    return q;
+  }
+
+  // Maps an existing segment. Throws std::system_error if it cannot be
+  // opened and std::runtime_error if it is not a fully created queue of
+  // this type.
+  static shm_queue open(const std::string& name) {
+    int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) fail("shm_open");
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+      int error = errno;
+      ::close(fd);
+      errno = error;
+      fail("fstat");
+    }
+    size_t bytes = static_cast<size_t>(st.st_size);
+    if (bytes < sizeof(header)) {
+      ::close(fd);
+      throw std::runtime_error("shm_queue: segment too small");
+    }
+    shm_queue q(map(fd, bytes), bytes);
+    const header* h = q.header_;
+    if (h->magic.load(std::memory_order_acquire) != kMagic ||
+        h->value_size != sizeof(value_type) ||
+        h->multi_producer != MultiProducer ||
+        bytes != segment_size(h->capacity)) {
+      throw std::runtime_error("shm_queue: incompatible segment");
+    }
+    q.attach();
+    return q;
+  }
+
+  static bool unlink(const std::string& name) {
+    return ::shm_unlink(name.c_str()) == 0;
+  }
+
+  shm_queue(shm_queue&& other) noexcept { swap(other); }
+  shm_queue& operator=(shm_queue&& other) noexcept {
+    swap(other);
+    return *this;
+  }
+
+  // Unmaps the segment. No thread of this process may use the queue while
+  // it is destroyed.
+  ~shm_queue() {
+    if (header_ != nullptr) ::munmap(header_, bytes_);
+  }
+
+  bool try_push(const value_type& value) {
+    if constexpr (MultiProducer) {
+      uint64_t pos = header_->tail.load(std::memory_order_relaxed);
+      while (true) {
+        slot& s = slots_[pos & mask_];
+        uint64_t sequence = s.sequence.load(std::memory_order_acquire);
+        int64_t lag = static_cast<int64_t>(sequence - pos);
+        if (lag == 0) {
+          if (header_->tail.compare_exchange_weak(pos, pos + 1,
+                                                  std::memory_order_relaxed)) {
+            new (&s.value) value_type(value);
+            s.sequence.store(pos + 1, std::memory_order_release);
+            return true;
+          }
+        } else if (lag < 0) {
+          return false;
+        } else {
+          pos = header_->tail.load(std::memory_order_relaxed);
+        }
+      }
+    } else {
+      uint64_t tail = header_->tail.load(std::memory_order_relaxed);
+      if (tail - cached_head_ == capacity()) {
+        cached_head_ = header_->head.load(std::memory_order_acquire);
+        if (tail - cached_head_ == capacity()) return false;
+      }
+      new (&slots_[tail & mask_]) value_type(value);
+      header_->tail.store(tail + 1, std::memory_order_release);
+      return true;
+    }
+  }
+
+  // Consumer only.
+  bool try_pop(value_type& out) {
+    uint64_t head = header_->head.load(std::memory_order_relaxed);
+    if constexpr (MultiProducer) {
+      slot& s = slots_[head & mask_];
+      if (s.sequence.load(std::memory_order_acquire) != head + 1) return false;
+      out = s.value;
+      s.sequence.store(head + capacity(), std::memory_order_release);
+    } else {
+      if (head == cached_tail_) {
+        cached_tail_ = header_->tail.load(std::memory_order_acquire);
+        if (head == cached_tail_) return false;
+      }
+      out = slots_[head & mask_];
+    }
+    header_->head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Spin briefly, then yield until the operation succeeds.
+  void push(const value_type& value) {
+    wait_until([&] { return try_push(value); });
+  }
+  void pop(value_type& out) {
+    wait_until([&] { return try_pop(out); });
+  }
+
+  // Approximate while other processes push or pop.
+  size_type size() const {
+    uint64_t head = header_->head.load(std::memory_order_acquire);
+    uint64_t tail = header_->tail.load(std::memory_order_acquire);
+    return tail > head ? static_cast<size_type>(tail - head) : 0;
+  }
+  bool empty() const { return size() == 0; }
+  size_type capacity() const { return static_cast<size_type>(mask_ + 1); }
+
+ private:
+  static constexpr uint64_t kMagic = 0x6c6163652d73686dULL;  // "lace-shm"
+  static constexpr int kSpins = 64;
+
+  struct alignas(64) header {
+    std::atomic<uint64_t> magic{0};
+    uint64_t capacity = 0;
+    uint64_t value_size = 0;
+    uint64_t multi_producer = 0;
+    alignas(64) std::atomic<uint64_t> tail{0};
+    alignas(64) std::atomic<uint64_t> head{0};
+  };
+
+  struct alignas(64) sequenced_slot {
+    std::atomic<uint64_t> sequence;
+    value_type value;
+  };
+
+  using slot = std::conditional_t<MultiProducer, sequenced_slot, value_type>;
+
+  header* header_ = nullptr;
+  slot* slots_ = nullptr;
+  size_t bytes_ = 0;
+  uint64_t mask_ = 0;
+  // This process's last view of the other side's counter (single producer
+  // only).
+  uint64_t cached_head_ = 0;
+  uint64_t cached_tail_ = 0;
+
+  shm_queue(void* memory, size_t bytes)
+      : header_(static_cast<header*>(memory)), bytes_(bytes) {}
+
+  // The largest power of two whose segment size fits in size_t.
+  static constexpr uint64_t max_slots() {
+    uint64_t limit =
+        (std::numeric_limits<size_t>::max() - sizeof(header)) / sizeof(slot);
+    uint64_t slots = 2;
+    while (slots <= limit / 2) slots *= 2;
+    return slots;
+  }
+
+  static size_t segment_size(uint64_t capacity) {
+    return sizeof(header) + static_cast<size_t>(capacity) * sizeof(slot);
+  }
+
+  [[noreturn]] static void fail(const char* what) {
+    throw std::system_error(errno, std::generic_category(), what);
+  }
+
+  // Maps the object behind fd and closes fd; the mapping keeps it alive.
+  static void* map(int fd, size_t bytes) {
+    void* memory =
+        ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    int error = errno;
+    ::close(fd);
+    if (memory == MAP_FAILED) {
+      errno = error;
+      fail("mmap");
+    }
+    return memory;
+  }
+
+  void attach() {
+    slots_ = reinterpret_cast<slot*>(reinterpret_cast<char*>(header_) +
+                                     sizeof(header));
+    mask_ = header_->capacity - 1;
+    cached_head_ = header_->head.load(std::memory_order_acquire);
+    cached_tail_ = header_->tail.load(std::memory_order_acquire);
+  }
+
+  void swap(shm_queue& other) noexcept {
+    std::swap(header_, other.header_);
+    std::swap(slots_, other.slots_);
+    std::swap(bytes_, other.bytes_);
+    std::swap(mask_, other.mask_);
+    std::swap(cached_head_, other.cached_head_);
+    std::swap(cached_tail_, other.cached_tail_);
+  }
+
+  template <typename Attempt>
+  static void wait_until(Attempt attempt) {
+    for (int spin = 0; !attempt(); ++spin) {
+      if (spin >= kSpins) std::this_thread::yield();
+    }
+  }
+};  // shm_queue
+
+// Any number of producer processes, one consumer.
+template <typename T>
+using shm_mpsc_queue = shm_queue<T, true>;
+}  // namespace lace
+#endif  // _LACE_SHM_QUEUE_H_
@@ -0,0 +1,161 @@
+#ifndef _LACE_SPSC_QUEUE_H_
+#define _LACE_SPSC_QUEUE_H_
+
+#include <atomic>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+namespace lace {
+
+// Bounded wait-free queue for exactly one producer thread and one consumer
+// thread. Elements live in a power-of-two ring of slots indexed by two
+// ever-increasing counters, the producer's tail and the consumer's head,
+// each on its own cache line. Each side also keeps a private copy of
+// the other side's counter and only reloads it when the copy says the queue
+// is full (or empty), so in the steady state neither side touches the other's
+// cache line.
+//
+// try_push and push_n may only be called by the producer, try_pop and pop_n
+// only by the consumer.
+template <typename T>
+class spsc_queue {
+ public:
+  using value_type = T;
+  using size_type = size_t;
+
+  // The capacity is rounded up to a power of two. Throws std::length_error
+  // when it exceeds max_capacity().
+  explicit spsc_queue(size_type capacity) {
+    if (capacity > max_capacity()) {
+      throw std::length_error("spsc_queue capacity too large");
+    }
+    capacity_ = 1;
+    while (capacity_ < capacity) capacity_ *= 2;
+    slots_ = std::allocator<value_type>().allocate(capacity_);
+  }
+
+  spsc_queue(const spsc_queue&) = delete;
+  spsc_queue& operator=(const spsc_queue&) = delete;
+
+  // Neither thread may use the queue while it is destroyed.
+  ~spsc_queue() {
+    size_t tail = producer_.own.load(std::memory_order_relaxed);
+    for (size_t i = consumer_.own.load(std::memory_order_relaxed); i != tail;
+         ++i) {
+      slot(i)->~value_type();
+    }
+    std::allocator<value_type>().deallocate(slots_, capacity_);
+  }
+
+  bool try_push(const value_type& value) { return try_emplace(value); }
+  bool try_push(value_type&& value) { return try_emplace(std::move(value)); }
+
+  template <typename... Args>
+  bool try_emplace(Args&&... args) {
+    size_t tail = producer_.own.load(std::memory_order_relaxed);
+    if (tail - producer_.cached == capacity_) {
+      producer_.cached = consumer_.own.load(std::memory_order_acquire);
+      if (tail - producer_.cached == capacity_) return false;
+    }
+    new (slot(tail)) value_type(std::forward<Args>(args)...);
+    producer_.own.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool try_pop(value_type& out) {
+    size_t head = consumer_.own.load(std::memory_order_relaxed);
+    if (head == consumer_.cached) {
+      consumer_.cached = producer_.own.load(std::memory_order_acquire);
+      if (head == consumer_.cached) return false;
+    }
+    value_type* item = slot(head);
+    out = std::move(*item);
+    item->~value_type();
+    consumer_.own.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Pushes as many of the n elements starting at first as fit, publishing
+  // them with a single store. Returns how many were pushed.
+  template <typename InputIt>
+  size_type push_n(InputIt first, size_type n) {
+    size_t tail = producer_.own.load(std::memory_order_relaxed);
+    if (capacity_ - (tail - producer_.cached) < n) {
+      producer_.cached = consumer_.own.load(std::memory_order_acquire);
+    }
+    size_type room = capacity_ - (tail - producer_.cached);
+    size_type count = n < room ? n : room;
+    size_type built = 0;
+    try {
+      for (; built < count; ++built, ++first) {
+        new (slot(tail + built)) value_type(*first);
+      }
+    } catch (...) {
+      producer_.own.store(tail + built, std::memory_order_release);
+      throw;
+    }
+    if (count != 0) {
+      producer_.own.store(tail + count, std::memory_order_release);
+    }
+    return count;
+  }
+
+  // Moves up to n elements to out and frees their slots with a single store.
+  // Returns how many were popped.
+  template <typename OutputIt>
+  size_type pop_n(OutputIt out, size_type n) {
+    size_t head = consumer_.own.load(std::memory_order_relaxed);
+    if (consumer_.cached - head < n) {
+      consumer_.cached = producer_.own.load(std::memory_order_acquire);
+    }
+    size_type available = consumer_.cached - head;
+    size_type count = n < available ? n : available;
+    for (size_type i = 0; i < count; ++i, ++out) {
+      value_type* item = slot(head + i);
+      *out = std::move(*item);
+      item->~value_type();
+    }
+    if (count != 0) {
+      consumer_.own.store(head + count, std::memory_order_release);
+    }
+    return count;
+  }
+
+  // Exact only when neither side is active.
+  size_type size() const {
+    size_t head = consumer_.own.load(std::memory_order_acquire);
+    return producer_.own.load(std::memory_order_acquire) - head;
+  }
+  bool empty() const { return size() == 0; }
+  size_type capacity() const { return capacity_; }
+
+  // Largest power of two the allocator can provide.
+  static size_type max_capacity() {
+    size_type limit =
+        std::allocator_traits<std::allocator<value_type>>::max_size(
+            std::allocator<value_type>());
+    size_type capacity = 1;
+    while (capacity <= limit / 2) capacity *= 2;
+    return capacity;
+  }
+
+ private:
+  // One side's counter and its cached view of the other side's counter.
+  struct alignas(64) side {
+    std::atomic<size_t> own{0};
+    size_t cached = 0;
+  };
+
+  side producer_;
+  side consumer_;
+  value_type* slots_;
+  size_type capacity_;
+
+  value_type* slot(size_t index) const {
+    return slots_ + (index & (capacity_ - 1));
+  }
+};  // spsc_queue
+}  // namespace lace
+#endif  // _LACE_SPSC_QUEUE_H_
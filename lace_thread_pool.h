@@ -0,0 +1,243 @@
+#ifndef _LACE_THREAD_POOL_H_
+#define _LACE_THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "lace_queue.h"
+#include "lace_ws_deque.h"
+
+namespace lace {
+
+// Fixed set of worker threads with one work-stealing deque each. A task
+// submitted from a worker goes on that worker's deque, which the worker
+// treats as a stack, so recursive fork-join work stays on the thread (and in
+// the cache) that created it. Idle workers steal the oldest task of a random
+// victim, which tends to be the largest piece of outstanding work. Tasks
+// submitted from other threads go through a shared queue.
+//
+// Workers sleep on a condition variable when no task is queued anywhere;
+// submit only takes the lock to wake one when somebody sleeps.
+class thread_pool {
+ public:
+  // 0 means one worker per hardware thread.
+  explicit thread_pool(unsigned threads = 0) {
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+    for (unsigned i = 0; i < threads; ++i) {
+      workers_.push_back(std::make_unique<worker>());
+    }
+    for (size_t i = 0; i < workers_.size(); ++i) {
+      workers_[i]->thread = std::thread([this, i] { work(i); });
+    }
+  }
+
+  thread_pool(const thread_pool&) = delete;
+  thread_pool& operator=(const thread_pool&) = delete;
+
+  // Runs every task submitted so far, including the ones they submit, then
+  // joins the workers.
+  ~thread_pool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& w : workers_) w->thread.join();
+  }
+
+  // Queues fn() to run on some worker. An exception escaping fn terminates
+  // the program; use task_group to collect results and errors. If queueing
+  // throws (std::bad_alloc while a queue grows), the task is dropped and the
+  // pool is unchanged.
+  template <typename Fn>
+  void submit(Fn&& fn) {
+    auto t = std::make_unique<task>(std::forward<Fn>(fn));
+    slot& self = current();
+    if (self.pool == this) {
+      workers_[self.index]->tasks.push(t.get());
+    } else {
+      std::lock_guard<std::mutex> lock(mutex_);
+      injected_.push(t.get());
+    }
+    // Queued: from here on whoever takes the task owns it.
+    t.release();
+    queued_.fetch_add(1);
+    if (sleepers_.load() > 0) {
+      { std::lock_guard<std::mutex> lock(mutex_); }
+      wake_.notify_one();
+    }
+  }
+
+  // Runs one queued task on the calling thread. Returns false if none was
+  // found. Threads waiting for tasks to finish call this to help.
+  bool run_pending() {
+    task* t = take();
+    if (t == nullptr) return false;
+    run(t);
+    return true;
+  }
+
+  unsigned size() const { return static_cast<unsigned>(workers_.size()); }
+
+  // Process-wide pool with one worker per hardware thread, started on first
+  // use. The parallel algorithms run on it.
+  static thread_pool& shared() {
+    static thread_pool pool;
+    return pool;
+  }
+
+ private:
+  using task = std::function<void()>;
+
+  struct alignas(64) worker {
+    ws_deque<task*> tasks;
+    std::thread thread;
+  };
+
+  // What the calling thread is: a worker of pool, or no worker if pool is
+  // null. Also seeds its choice of victims.
+  struct slot {
+    const thread_pool* pool = nullptr;
+    size_t index = 0;
+    uint64_t random = 0;
+  };
+
+  std::vector<std::unique_ptr<worker>> workers_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  queue<task*> injected_;  // Guarded by mutex_.
+  bool stop_ = false;      // Guarded by mutex_.
+  // Tasks submitted and not yet taken by any thread. Counted after the task
+  // is queued, so it dips below zero when a thief is quicker.
+  std::atomic<int64_t> queued_{0};
+  std::atomic<size_t> sleepers_{0};
+
+  static slot& current() {
+    static thread_local slot self;
+    return self;
+  }
+
+  void work(size_t index) {
+    slot& self = current();
+    self.pool = this;
+    self.index = index;
+    while (true) {
+      if (task* t = take()) {
+        run(t);
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(mutex_);
+      if (stop_ && queued_.load() <= 0) return;
+      // Paired with submit: either this sees the new task in queued_, or
+      // submit sees this thread in sleepers_ and wakes it.
+      sleepers_.fetch_add(1);
+      wake_.wait(lock, [this] { return queued_.load() > 0 || stop_; });
+      sleepers_.fetch_sub(1);
+    }
+  }
+
+  // Own deque first, then a steal from every other worker starting at a
+  // random one, then the shared queue.
+  task* take() {
+    slot& self = current();
+    bool own = self.pool == this;
+    if (own) {
+      if (auto t = workers_[self.index]->tasks.pop()) return claimed(*t);
+    }
+    if (self.random == 0) {
+      self.random = reinterpret_cast<uintptr_t>(&self) | 1;
+    }
+    self.random ^= self.random << 13;
+    self.random ^= self.random >> 7;
+    self.random ^= self.random << 17;
+    size_t n = workers_.size();
+    size_t start = static_cast<size_t>(self.random % n);
+    for (size_t i = 0; i < n; ++i) {
+      size_t victim = (start + i) % n;
+      if (own && victim == self.index) continue;
+      if (auto t = workers_[victim]->tasks.steal()) return claimed(*t);
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (injected_.empty()) return nullptr;
+    task* t = injected_.front();
+    injected_.pop();
+    return claimed(t);
+  }
+
+  task* claimed(task* t) {
+    queued_.fetch_sub(1);
+    return t;
+  }
+
+  static void run(task* t) {
+    std::unique_ptr<task> owned(t);
+    (*owned)();
+  }
+};  // thread_pool
+
+// Fork-join scope over a thread_pool: run() submits tasks and wait() returns
+// once they have all finished. The waiting thread runs queued tasks itself
+// in the meantime, so tasks may create and wait for groups of their own
+// without tying up workers. The first exception thrown by a task is
+// rethrown from wait().
+class task_group {
+ public:
+  explicit task_group(thread_pool& pool = thread_pool::shared())
+      : pool_(pool) {}
+
+  task_group(const task_group&) = delete;
+  task_group& operator=(const task_group&) = delete;
+
+  // Waits, but drops any exception that wait() would have thrown.
+  ~task_group() { join(); }
+
+  template <typename Fn>
+  void run(Fn fn) {
+    pending_.fetch_add(1, std::memory_order_relaxed);
+    pool_.submit([this, fn = std::move(fn)]() mutable {
+      try {
+        // Destroyed before the group is released.
+        Fn body = std::move(fn);
+        body();
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!error_) error_ = std::current_exception();
+      }
+      // Last use of this group: wait() may return and destroy it.
+      pending_.fetch_sub(1, std::memory_order_release);
+    });
+  }
+
+  void wait() {
+    join();
+    std::exception_ptr error;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      std::swap(error, error_);
+    }
+    if (error) std::rethrow_exception(error);
+  }
+
+ private:
+  thread_pool& pool_;
+  std::atomic<size_t> pending_{0};
+  std::mutex mutex_;
+  std::exception_ptr error_;
+
+  void join() {
+    while (pending_.load(std::memory_order_acquire) > 0) {
+      if (!pool_.run_pending()) std::this_thread::yield();
+    }
+  }
+};  // task_group
+}  // namespace lace
+#endif  // _LACE_THREAD_POOL_H_
@@ -0,0 +1,234 @@
+#ifndef _LACE_UNROLLED_LIST_H_
+#define _LACE_UNROLLED_LIST_H_
+
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+namespace lace {
+
+namespace detail {
+
+// About 4 KiB of elements per chunk, and at least 16.
+template <typename T>
+constexpr size_t default_chunk_size() {
+  return sizeof(T) <= 256 ? 4096 / sizeof(T) : 16;
+}
+
+}  // namespace detail
+
+// FIFO storage in a singly linked list of fixed-size chunks. Pushing fills
+// the tail chunk and pops drain the head chunk, so elements never move and
+// memory grows and shrinks one chunk at a time instead of doubling like
+// ring_buffer. A drained chunk goes to a cache of at most CachedChunks
+// chunks and is reused by the next push that needs one; beyond that it is
+// freed straight away. A queue that keeps cycling through a few chunks
+// therefore never allocates, and one that shrinks after a spike gives the
+// memory back.
+//
+// Provides the push_back/pop_front/front/back interface lace::queue expects
+// of its container.
+template <typename T, size_t ChunkSize = detail::default_chunk_size<T>(),
+          size_t CachedChunks = 4>
+class unrolled_list {
+  static_assert(ChunkSize > 0, "unrolled_list needs non-empty chunks");
+
+ public:
+  using value_type = T;
+  using reference = T&;
+  using const_reference = const T&;
+  using size_type = size_t;
+
+  unrolled_list() noexcept = default;
+
+  // Delegating to the default constructor makes the list fully constructed
+  // before the first copy, so the destructor frees the copies made so far if
+  // a later one throws.
+  unrolled_list(std::initializer_list<value_type> const& items)
+      : unrolled_list() {
+    for (const auto& item : items) push_back(item);
+  }
+
+  unrolled_list(const unrolled_list& other) : unrolled_list() {
+    other.for_each([this](const value_type& item) { push_back(item); });
+  }
+
+  unrolled_list(unrolled_list&& other) noexcept { swap(other); }
+
+  unrolled_list& operator=(unrolled_list other) noexcept {
+    swap(other);
+    return *this;
+  }
+
+  ~unrolled_list() {
+    clear();
+    shrink_to_fit();
+  }
+
+  void push_back(const_reference value) { emplace_back(value); }
+  void push_back(value_type&& value) { emplace_back(std::move(value)); }
+
+  template <typename... Args>
+  reference emplace_back(Args&&... args) {
+    if (tail_ != nullptr && end_ < ChunkSize) {
+      new (tail_->slot(end_)) value_type(std::forward<Args>(args)...);
+    } else {
+      chunk* c = acquire();
+      try {
+        new (c->slot(0)) value_type(std::forward<Args>(args)...);
+      } catch (...) {
+        release(c);
+        throw;
+      }
+      if (tail_ != nullptr) {
+        tail_->next = c;
+      } else {
+        head_ = c;
+        begin_ = 0;
+      }
+      tail_ = c;
+      end_ = 0;
+    }
+    ++end_;
+    ++size_;
+    return back();
+  }
+
+  void pop_front() {
+    if (size_ == 0) {
+      throw std::out_of_range("pop_front on empty unrolled_list");
+    }
+    head_->slot(begin_)->~value_type();
+    ++begin_;
+    --size_;
+    if (size_ == 0) {
+      // Keep the last chunk for the next push.
+      begin_ = end_ = 0;
+    } else if (begin_ == ChunkSize) {
+      chunk* drained = head_;
+      head_ = head_->next;
+      begin_ = 0;
+      release(drained);
+    }
+  }
+
+  reference front() { return *checked(head_, begin_); }
+  const_reference front() const { return *checked(head_, begin_); }
+  reference back() { return *checked(tail_, end_ - 1); }
+  const_reference back() const { return *checked(tail_, end_ - 1); }
+
+  size_type size() const noexcept { return size_; }
+  bool empty() const noexcept { return size_ == 0; }
+
+  // Chunks held, in use or cached.
+  size_type allocated_chunks() const noexcept {
+    size_type count = cached_;
+    for (chunk* c = head_; c != nullptr; c = c->next) ++count;
+    return count;
+  }
+
+  // Destroys the elements; their chunks go to the cache as far as it has
+  // room.
+  void clear() noexcept {
+    for_each([](value_type& item) { item.~value_type(); });
+    while (head_ != nullptr) {
+      chunk* c = head_;
+      head_ = head_->next;
+      release(c);
+    }
+    tail_ = nullptr;
+    begin_ = end_ = 0;
+    size_ = 0;
+  }
+
+  // Frees the cached chunks.
+  void shrink_to_fit() noexcept {
+    while (free_ != nullptr) {
+      chunk* c = free_;
+      free_ = free_->next;
+      delete c;
+    }
+    cached_ = 0;
+  }
+
+  void swap(unrolled_list& other) noexcept {
+    std::swap(head_, other.head_);
+    std::swap(tail_, other.tail_);
+    std::swap(begin_, other.begin_);
+    std::swap(end_, other.end_);
+    std::swap(size_, other.size_);
+    std::swap(free_, other.free_);
+    std::swap(cached_, other.cached_);
+  }
+
+ private:
+  struct chunk {
+    chunk* next = nullptr;
+    alignas(value_type) unsigned char storage[ChunkSize * sizeof(value_type)];
+
+    value_type* slot(size_t i) {
+      return std::launder(reinterpret_cast<value_type*>(storage)) + i;
+    }
+    const value_type* slot(size_t i) const {
+      return std::launder(reinterpret_cast<const value_type*>(storage)) + i;
+    }
+  };
+
+  chunk* head_ = nullptr;
+  chunk* tail_ = nullptr;
+  // Live elements are [begin_, ChunkSize) of head_, every slot of the
+  // chunks in between, and [0, end_) of tail_.
+  size_type begin_ = 0;
+  size_type end_ = 0;
+  size_type size_ = 0;
+  chunk* free_ = nullptr;
+  size_type cached_ = 0;
+
+  chunk* acquire() {
+    if (free_ == nullptr) return new chunk;
+    chunk* c = free_;
+    free_ = c->next;
+    c->next = nullptr;
+    --cached_;
+    return c;
+  }
+
+  void release(chunk* c) noexcept {
+    if (cached_ < CachedChunks) {
+      c->next = free_;
+      free_ = c;
+      ++cached_;
+    } else {
+      delete c;
+    }
+  }
+
+  value_type* checked(chunk* c, size_type i) {
+    if (size_ == 0) throw std::out_of_range("Accessing empty unrolled_list");
+    return c->slot(i);
+  }
+  const value_type* checked(chunk* c, size_type i) const {
+    if (size_ == 0) throw std::out_of_range("Accessing empty unrolled_list");
+    return c->slot(i);
+  }
+
+  template <typename Fn>
+  void for_each(Fn fn) const {
+    if (size_ == 0) return;
+    for (const chunk* c = head_; c != nullptr; c = c->next) {
+      size_type first = c == head_ ? begin_ : 0;
+      size_type last = c == tail_ ? end_ : ChunkSize;
+      for (size_type i = first; i < last; ++i) fn(*c->slot(i));
+    }
+  }
+  // The list is not const here, so neither are its elements.
+  template <typename Fn>
+  void for_each(Fn fn) {
+    std::as_const(*this).for_each(
+        [&fn](const value_type& item) { fn(const_cast<value_type&>(item)); });
+  }
+};  // unrolled_list
+}  // namespace lace
+#endif  // _LACE_UNROLLED_LIST_H_
@@ -0,0 +1,149 @@
+#ifndef _LACE_WS_DEQUE_H_
+#define _LACE_WS_DEQUE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace lace {
+
+// Chase-Lev work-stealing deque (with the memory orders of Le et al., "Correct
+// and Efficient Work-Stealing for Weak Memory Models"). One owner thread
+// pushes and pops at the bottom, like a stack; any other thread may steal from
+// the top. The owner only synchronises with thieves when the deque is down to
+// its last element.
+//
+// Elements are stored in atomics, so T must be trivially copyable (typically a
+// pointer to a task). The ring grows by doubling; outgrown rings are kept
+// until the deque is destroyed because a thief may still be reading one.
+template <typename T>
+class ws_deque {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "ws_deque needs trivially copyable elements");
+
+ public:
+  using value_type = T;
+  using size_type = size_t;
+
+  // Throws std::length_error when capacity exceeds max_capacity().
+  explicit ws_deque(size_type capacity = 64) {
+    if (capacity > max_capacity()) {
+      throw std::length_error("ws_deque capacity too large");
+    }
+    size_type size = 1;
+    while (size < capacity) size *= 2;
+    rings_.push_back(std::make_unique<ring>(size));
+    ring_.store(rings_.back().get(), std::memory_order_relaxed);
+  }
+
+  ws_deque(const ws_deque&) = delete;
+  ws_deque& operator=(const ws_deque&) = delete;
+
+  // Owner only.
+  void push(value_type value) {
+    int64_t bottom = bottom_.load(std::memory_order_relaxed);
+    int64_t top = top_.load(std::memory_order_acquire);
+    ring* r = ring_.load(std::memory_order_relaxed);
+    if (bottom - top > static_cast<int64_t>(r->mask)) r = grow(r, top, bottom);
+    r->put(bottom, value);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+  }
+
+  // Owner only. Takes the most recently pushed element.
+  std::optional<value_type> pop() {
+    int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+    ring* r = ring_.load(std::memory_order_relaxed);
+    bottom_.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = top_.load(std::memory_order_relaxed);
+    if (top > bottom) {
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+      return std::nullopt;
+    }
+    value_type value = r->get(bottom);
+    if (top == bottom) {
+      // Last element: race the thieves for it.
+      bool won = top_.compare_exchange_strong(
+          top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+      if (!won) return std::nullopt;
+    }
+    return value;
+  }
+
+  // Any thread. Takes the oldest element; fails when the deque is empty or
+  // another thread took that element first.
+  std::optional<value_type> steal() {
+    int64_t top = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t bottom = bottom_.load(std::memory_order_acquire);
+    if (top >= bottom) return std::nullopt;
+    ring* r = ring_.load(std::memory_order_acquire);
+    value_type value = r->get(top);
+    if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed)) {
+      return std::nullopt;
+    }
+    return value;
+  }
+
+  // Approximate while other threads steal.
+  size_type size() const {
+    int64_t bottom = bottom_.load(std::memory_order_relaxed);
+    int64_t top = top_.load(std::memory_order_relaxed);
+    return bottom > top ? static_cast<size_type>(bottom - top) : 0;
+  }
+  bool empty() const { return size() == 0; }
+
+  // Largest power of two the ring can hold.
+  static constexpr size_type max_capacity() {
+    size_type limit = std::numeric_limits<size_type>::max() /
+                      sizeof(std::atomic<value_type>);
+    size_type size = 1;
+    while (size <= limit / 2) size *= 2;
+    return size;
+  }
+
+ private:
+  struct ring {
+    const size_type mask;
+    std::unique_ptr<std::atomic<value_type>[]> slots;
+
+    explicit ring(size_type size)
+        : mask(size - 1), slots(new std::atomic<value_type>[size]) {}
+
+    void put(int64_t index, value_type value) {
+      slots[static_cast<size_type>(index) & mask].store(
+          value, std::memory_order_relaxed);
+    }
+    value_type get(int64_t index) const {
+      return slots[static_cast<size_type>(index) & mask].load(
+          std::memory_order_relaxed);
+    }
+  };
+
+  alignas(64) std::atomic<int64_t> top_{0};
+  alignas(64) std::atomic<int64_t> bottom_{0};
+  std::atomic<ring*> ring_;
+  // Owner only.
+  std::vector<std::unique_ptr<ring>> rings_;
+
+  ring* grow(ring* old, int64_t top, int64_t bottom) {
+    if (old->mask + 1 == max_capacity()) {
+      throw std::length_error("ws_deque too large");
+    }
+    rings_.push_back(std::make_unique<ring>(2 * (old->mask + 1)));
+    ring* bigger = rings_.back().get();
+    for (int64_t i = top; i < bottom; ++i) bigger->put(i, old->get(i));
+    ring_.store(bigger, std::memory_order_release);
+    return bigger;
+  }
+};  // ws_deque
+}  // namespace lace
+#endif  // _LACE_WS_DEQUE_H_
@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "../lace_blocking_queue.h"
+
+using namespace std::chrono_literals;
+
+TEST(BlockingQueueTest, PushPopAndTimeouts) {
+  lace::blocking_queue<int> q;
+  EXPECT_EQ(q.capacity(), lace::blocking_queue<int>::kUnbounded);
+  int out = 0;
+  EXPECT_FALSE(q.try_pop(out));
+  EXPECT_FALSE(q.pop_for(out, 5ms));
+  EXPECT_TRUE(q.push(1));
+  EXPECT_TRUE(q.try_push(2));
+  EXPECT_EQ(q.size(), 2);
+  EXPECT_TRUE(q.pop(out));
+  EXPECT_EQ(out, 1);
+  EXPECT_TRUE(q.pop_for(out, 5ms));
+  EXPECT_EQ(out, 2);
+  EXPECT_TRUE(q.empty());
+}
+
+TEST(BlockingQueueTest, BoundedQueueAppliesBackpressure) {
+  lace::blocking_queue<std::unique_ptr<int>> q(2);
+  EXPECT_TRUE(q.push(std::make_unique<int>(0)));
+  EXPECT_TRUE(q.push(std::make_unique<int>(1)));
+  EXPECT_FALSE(q.try_push(std::make_unique<int>(2)));
+
+  std::atomic<bool> pushed{false};
+  std::thread producer([&] {
+    EXPECT_TRUE(q.push(std::make_unique<int>(2)));
+    pushed = true;
+  });
+  std::this_thread::sleep_for(20ms);
+  EXPECT_FALSE(pushed);
+  std::unique_ptr<int> out;
+  EXPECT_TRUE(q.pop(out));
+  EXPECT_EQ(*out, 0);
+  producer.join();
+  EXPECT_TRUE(pushed);
+  EXPECT_EQ(q.size(), 2);
+}
+
+TEST(BlockingQueueTest, DrainMovesABatch) {
+  lace::blocking_queue<int> q;
+  for (int i = 0; i < 10; ++i) q.push(i);
+  std::vector<int> out;
+  EXPECT_EQ(q.drain(std::back_inserter(out), 4), 4);
+  EXPECT_EQ(q.drain(std::back_inserter(out), 100), 6);
+  EXPECT_EQ(out, std::vector<int>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+
+  std::thread late([&q] {
+    std::this_thread::sleep_for(10ms);
+    q.push(42);
+  });
+  out.clear();
+  EXPECT_EQ(q.drain(std::back_inserter(out), 8), 1);
+  EXPECT_EQ(out, std::vector<int>({42}));
+  late.join();
+
+  // An empty batch is returned at once rather than waiting for an item.
+  EXPECT_EQ(q.drain(std::back_inserter(out), 0), 0);
+  q.push(7);
+  EXPECT_EQ(q.drain(std::back_inserter(out), 0), 0);
+  EXPECT_EQ(q.size(), 1);
+}
+
+TEST(BlockingQueueTest, CloseWakesWaitersAndKeepsItems) {
+  lace::blocking_queue<int> q(1);
+  q.push(7);
+  std::vector<std::thread> waiters;
+  std::atomic<int> failed_pushes{0};
+  for (int i = 0; i < 3; ++i) {
+    waiters.emplace_back([&q, &failed_pushes, i] {
+      if (!q.push(i)) failed_pushes++;
+    });
+  }
+  std::this_thread::sleep_for(10ms);
+  q.close();
+  for (auto& w : waiters) w.join();
+  EXPECT_EQ(failed_pushes, 3);
+  EXPECT_TRUE(q.closed());
+
+  int out = 0;
+  EXPECT_TRUE(q.pop(out));
+  EXPECT_EQ(out, 7);
+  EXPECT_FALSE(q.pop(out));
+  std::vector<int> rest;
+  EXPECT_EQ(q.drain(std::back_inserter(rest), 5), 0);
+  EXPECT_FALSE(q.push(1));
+}
+
+TEST(BlockingQueueTest, ProducersAndConsumers) {
+  lace::blocking_queue<int> q(16);
+  std::atomic<long> sum{0};
+  std::vector<std::thread> threads;
+  for (int p = 0; p < 3; ++p) {
+    threads.emplace_back([&q, p] {
+      for (int i = 0; i < 10000; ++i) q.push(p * 10000 + i);
+    });
+  }
+  std::vector<std::thread> consumers;
+  for (int c = 0; c < 3; ++c) {
+    consumers.emplace_back([&q, &sum, c] {
+      int value;
+      std::vector<int> batch;
+      while (true) {
+        if (c == 0) {
+          batch.clear();
+          if (q.drain(std::back_inserter(batch), 8) == 0) return;
+          for (int v : batch) sum += v;
+        } else {
+          if (!q.pop(value)) return;
+          sum += value;
+        }
+      }
+    });
+  }
+  for (auto& t : threads) t.join();
+  q.close();
+  for (auto& c : consumers) c.join();
+  EXPECT_EQ(sum, 30000L * 29999 / 2);
+}
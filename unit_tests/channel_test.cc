@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../lace_channel.h"
+
+namespace {
+
+lace::job produce(lace::channel<int>& ch, int count, std::vector<int>& log) {
+  for (int i = 0; i < count; ++i) {
+    EXPECT_TRUE(co_await ch.send(i));
+    log.push_back(i);
+  }
+  ch.close();
+}
+
+lace::job consume(lace::channel<int>& ch, std::vector<int>& out) {
+  while (auto value = co_await ch.recv()) out.push_back(*value);
+}
+
+}  // namespace
+
+TEST(ChannelTest, UnboundedNeverWaitsToSend) {
+  lace::executor ex;
+  lace::channel<int> ch(ex);
+  std::vector<int> sent;
+  std::vector<int> received;
+  ex.spawn(produce(ch, 1000, sent));
+  ex.run();
+  EXPECT_EQ(sent.size(), 1000);
+  EXPECT_EQ(ch.size(), 1000);
+  ex.spawn(consume(ch, received));
+  ex.run();
+  EXPECT_TRUE(ex.idle());
+  ASSERT_EQ(received.size(), 1000);
+  for (int i = 0; i < 1000; ++i) EXPECT_EQ(received[i], i);
+}
+
+TEST(ChannelTest, BoundedSenderWaitsForRoom) {
+  for (size_t capacity : {0, 1, 3}) {
+    lace::executor ex;
+    lace::channel<int> ch(ex, capacity);
+    std::vector<int> sent;
+    std::vector<int> received;
+    ex.spawn(produce(ch, 100, sent));
+    ex.run();
+    // The producer sent what fits and waits for a receiver.
+    EXPECT_EQ(sent.size(), capacity);
+    EXPECT_EQ(ch.size(), capacity);
+    EXPECT_FALSE(ex.idle());
+    ex.spawn(consume(ch, received));
+    while (ex.run_one()) EXPECT_LE(ch.size(), capacity);
+    EXPECT_TRUE(ex.idle());
+    ASSERT_EQ(received.size(), 100);
+    for (int i = 0; i < 100; ++i) EXPECT_EQ(received[i], i);
+  }
+}
+
+TEST(ChannelTest, CloseWakesWaiters) {
+  lace::executor ex;
+  lace::channel<std::string> full(ex, 1);
+  lace::channel<std::string> empty(ex);
+  std::vector<std::string> results;
+  auto sender = [&]() -> lace::job {
+    results.push_back((co_await full.send("a")) ? "sent" : "refused");
+    results.push_back((co_await full.send("b")) ? "sent" : "refused");
+  };
+  auto receiver = [&]() -> lace::job {
+    auto value = co_await empty.recv();
+    results.push_back(value ? *value : "closed");
+  };
+  ex.spawn(sender());
+  ex.spawn(receiver());
+  ex.run();
+  EXPECT_EQ(results, std::vector<std::string>{"sent"});
+  full.close();
+  empty.close();
+  ex.run();
+  EXPECT_EQ(results,
+            (std::vector<std::string>{"sent", "refused", "closed"}));
+  EXPECT_EQ(full.try_recv(), "a");
+  EXPECT_FALSE(full.try_recv().has_value());
+  EXPECT_FALSE(full.try_send("c"));
+}
+
+TEST(ChannelTest, TrySendAndExecutorCleanup) {
+  auto tracked = std::make_shared<int>(0);
+  {
+    lace::executor ex;
+    lace::channel<std::shared_ptr<int>> ch(ex, 1);
+    EXPECT_TRUE(ch.try_send(tracked));
+    EXPECT_FALSE(ch.try_send(tracked));
+    auto stuck = [&](std::shared_ptr<int> held) -> lace::job {
+      co_await ch.send(held);
+    };
+    ex.spawn(stuck(tracked));
+    ex.run();
+    EXPECT_EQ(tracked.use_count(), 4);
+    EXPECT_FALSE(ex.idle());
+  }
+  // The executor destroyed the suspended job, and with it its frame.
+  EXPECT_EQ(tracked.use_count(), 1);
+}
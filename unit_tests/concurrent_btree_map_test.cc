@@ -0,0 +1,220 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "../lace_concurrent_btree_map.h"
+
+using BtreeInts = lace::concurrent_btree_map<int, int>;
+
+TEST(ConcurrentBtreeMapTest, BasicOperations) {
+  BtreeInts m;
+  EXPECT_TRUE(m.empty());
+  EXPECT_TRUE(m.insert(2, 20));
+  EXPECT_TRUE(m.insert({1, 10}));
+  EXPECT_FALSE(m.insert(2, 21));
+  EXPECT_EQ(m.at(2), 20);
+  EXPECT_FALSE(m.insert_or_assign(2, 22));
+  EXPECT_TRUE(m.insert_or_assign(3, 30));
+  EXPECT_EQ(m.size(), 3);
+  EXPECT_EQ(m.get(2), 22);
+  EXPECT_EQ(m.get(4), std::nullopt);
+  EXPECT_THROW(m.at(4), std::out_of_range);
+  EXPECT_TRUE(m.contains(1));
+  EXPECT_EQ(m.find(3)->second, 30);
+  EXPECT_EQ(m.find(4), m.end());
+
+  EXPECT_TRUE(m.erase(1));
+  EXPECT_FALSE(m.erase(1));
+  EXPECT_EQ(m.size(), 2);
+  EXPECT_THROW(*m.end(), std::runtime_error);
+}
+
+TEST(ConcurrentBtreeMapTest, SplitsKeepOrder) {
+  BtreeInts m;
+  const int n = 100000;
+  for (int i = 0; i < n; ++i) m.insert((i * 7919) % n, i);
+  EXPECT_EQ(m.size(), n);
+  EXPECT_GE(m.depth(), 3);
+
+  int expected = 0;
+  for (auto it = m.begin(); it != m.end(); ++it) {
+    EXPECT_EQ(it->first, expected);
+    expected++;
+  }
+  EXPECT_EQ(expected, n);
+  for (int i = 0; i < n; i += 997) EXPECT_EQ(m.at((i * 7919) % n), i);
+}
+
+TEST(ConcurrentBtreeMapTest, BoundsAndRanges) {
+  BtreeInts m;
+  for (int i = 0; i < 1000; ++i) m.insert(i * 2, i);
+  EXPECT_EQ(m.lower_bound(7)->first, 8);
+  EXPECT_EQ(m.lower_bound(8)->first, 8);
+  EXPECT_EQ(m.upper_bound(8)->first, 10);
+  EXPECT_EQ(m.lower_bound(1999), m.end());
+
+  std::vector<int> keys;
+  m.for_each_in_range(100, 140,
+                      [&](const auto& kv) { keys.push_back(kv.first); });
+  EXPECT_EQ(keys, std::vector<int>({100, 102, 104, 106, 108, 110, 112, 114, 116,
+                                    118, 120, 122, 124, 126, 128, 130, 132, 134,
+                                    136, 138}));
+  int visited = 0;
+  m.for_each_in_range(0, 2000, [&](const auto&) { return ++visited < 5; });
+  EXPECT_EQ(visited, 5);
+}
+
+TEST(ConcurrentBtreeMapTest, IterationSkipsEmptiedLeaves) {
+  BtreeInts m;
+  for (int i = 0; i < 1000; ++i) m.insert(i, i);
+  for (int i = 100; i < 900; ++i) m.erase(i);
+  auto it = m.lower_bound(50);
+  int count = 0;
+  int previous = 49;
+  for (; it != m.end(); ++it) {
+    EXPECT_LT(previous, it->first);
+    previous = it->first;
+    count++;
+  }
+  EXPECT_EQ(count, 150);
+  EXPECT_EQ(m.upper_bound(99)->first, 900);
+  auto copy = m.begin();
+  copy = m.find(950);
+  EXPECT_EQ(copy->second, 950);
+}
+
+TEST(ConcurrentBtreeMapTest, EmptiedLeavesAreReclaimed) {
+  BtreeInts m;
+  const int keys = 100000;
+  for (int i = 0; i < keys; ++i) m.insert(i, i);
+  size_t full = m.leaves();
+  EXPECT_GT(full, 1000u);
+
+  for (int round = 0; round < 3; ++round) {
+    // Odd keys first, then every other even key, then the rest, so leaves
+    // empty at every position under their parents.
+    for (int i = 1; i < keys; i += 2) m.erase(i);
+    for (int i = 0; i < keys; i += 4) m.erase(i);
+    for (int i = keys - 2; i >= 0; i -= 4) m.erase(i);
+    EXPECT_TRUE(m.empty());
+    // At most one leaf per parent survives, so a scan of the empty map
+    // visits a few dozen leaves rather than thousands.
+    EXPECT_LE(m.leaves(), full / 16);
+    EXPECT_EQ(m.begin(), m.end());
+    EXPECT_FALSE(m.contains(keys / 2));
+
+    for (int i = keys - 1; i >= 0; --i) m.insert(i, -i);
+    EXPECT_EQ(m.size(), keys);
+    EXPECT_LE(m.leaves(), 2 * full);
+  }
+  int expected = 0;
+  for (const auto& kv : m) {
+    EXPECT_EQ(kv.first, expected);
+    EXPECT_EQ(kv.second, -expected);
+    expected++;
+  }
+  EXPECT_EQ(expected, keys);
+}
+
+TEST(ConcurrentBtreeMapTest, ConcurrentErasesAndScans) {
+  BtreeInts m;
+  const int threads = 4;
+  const int keys = 40000;
+  for (int i = 0; i < keys; ++i) m.insert(i, i);
+  std::atomic<bool> done{false};
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&m, t] {
+      for (int i = t; i < keys; i += threads) EXPECT_TRUE(m.erase(i));
+    });
+  }
+  std::thread reader([&] {
+    while (!done) {
+      int previous = -1;
+      for (const auto& kv : m) {
+        EXPECT_LT(previous, kv.first);
+        EXPECT_EQ(kv.second, kv.first);
+        previous = kv.first;
+      }
+      EXPECT_FALSE(m.contains(-1));
+    }
+  });
+  for (auto& w : workers) w.join();
+  done = true;
+  reader.join();
+  EXPECT_TRUE(m.empty());
+  EXPECT_EQ(m.begin(), m.end());
+  EXPECT_LT(m.leaves(), 100u);
+}
+
+TEST(ConcurrentBtreeMapTest, ConcurrentInsertsAndReaders) {
+  BtreeInts m;
+  const int threads = 4;
+  const int per_thread = 20000;
+  std::atomic<bool> done{false};
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&m, t] {
+      for (int i = 0; i < per_thread; ++i) {
+        EXPECT_TRUE(m.insert(i * threads + t, t));
+      }
+    });
+  }
+  std::thread reader([&] {
+    while (!done) {
+      int previous = -1;
+      for (const auto& kv : m) {
+        EXPECT_LT(previous, kv.first);
+        EXPECT_EQ(kv.second, kv.first % threads);
+        previous = kv.first;
+      }
+    }
+  });
+  for (auto& w : workers) w.join();
+  done = true;
+  reader.join();
+
+  EXPECT_EQ(m.size(), threads * per_thread);
+  int expected = 0;
+  for (const auto& kv : m) EXPECT_EQ(kv.first, expected++);
+  EXPECT_EQ(expected, threads * per_thread);
+}
+
+TEST(ConcurrentBtreeMapTest, ConcurrentMixedStress) {
+  BtreeInts m;
+  const int keys = 2048;
+  std::atomic<long> inserted{0};
+  std::atomic<long> erased{0};
+  std::vector<std::thread> workers;
+  for (int t = 0; t < 4; ++t) {
+    workers.emplace_back([&, t] {
+      for (int i = 0; i < 20000; ++i) {
+        int key = (i * 31 + t * 17) % keys;
+        switch ((i + t) % 3) {
+          case 0:
+            if (m.insert(key, key)) inserted++;
+            break;
+          case 1:
+            if (m.erase(key)) erased++;
+            break;
+          default:
+            auto value = m.get(key);
+            if (value) {
+              EXPECT_EQ(*value, key);
+            }
+        }
+      }
+    });
+  }
+  for (auto& w : workers) w.join();
+
+  long live = 0;
+  for (const auto& kv : m) {
+    EXPECT_EQ(kv.first, kv.second);
+    live++;
+  }
+  EXPECT_EQ(live, inserted - erased);
+  EXPECT_EQ(static_cast<long>(m.size()), live);
+}
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "../lace_concurrent_counter_multiset.h"
+
+using CounterInts = lace::concurrent_counter_multiset<int>;
+
+TEST(ConcurrentCounterMultisetTest, BasicCounting) {
+  CounterInts counters;
+  EXPECT_TRUE(counters.empty());
+  counters.insert(3);
+  counters.insert(3);
+  counters.insert(1, 5);
+  counters.insert(7, 0);
+  EXPECT_EQ(counters.count(3), 2);
+  EXPECT_EQ(counters.count(1), 5);
+  EXPECT_EQ(counters.count(7), 0);
+  EXPECT_FALSE(counters.contains(7));
+  EXPECT_EQ(counters.size(), 7);
+
+  EXPECT_TRUE(counters.erase(3));
+  EXPECT_FALSE(counters.erase(3));
+  EXPECT_EQ(counters.count(3), 0);
+  counters.clear();
+  EXPECT_TRUE(counters.empty());
+}
+
+TEST(ConcurrentCounterMultisetTest, SnapshotIsOrdinaryMultiset) {
+  CounterInts counters;
+  for (int i = 0; i < 100; ++i) counters.insert(i % 10, i % 10 + 1);
+  lace::multiset<int> copy = counters.snapshot();
+  EXPECT_EQ(copy.size(), counters.size());
+  for (int key = 0; key < 10; ++key) EXPECT_EQ(copy.count(key), 10 * (key + 1));
+
+  counters.insert(0);
+  EXPECT_EQ(copy.count(0), 10);
+  int previous = -1;
+  for (int key : copy) {
+    EXPECT_LE(previous, key);
+    previous = key;
+  }
+}
+
+TEST(ConcurrentCounterMultisetTest, ConcurrentHotAndColdKeys) {
+  lace::concurrent_counter_multiset<int, 4> counters;
+  const int threads = 4;
+  const int per_thread = 20000;
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&counters, t] {
+      for (int i = 0; i < per_thread; ++i) {
+        counters.insert(i % 4 == 0 ? 1000 + i / 4 % 500 : i % 8);
+        if (i % 1000 == 0) counters.snapshot();
+      }
+      counters.insert(-t - 1, t + 1);
+    });
+  }
+  for (auto& w : workers) w.join();
+
+  for (int key = 0; key < 8; ++key) {
+    if (key % 4 == 0) {
+      EXPECT_EQ(counters.count(key), 0);
+    } else {
+      EXPECT_EQ(counters.count(key), threads * per_thread / 8);
+    }
+  }
+  for (int key = 1000; key < 1500; ++key) {
+    EXPECT_EQ(counters.count(key), threads * per_thread / 4 / 500);
+  }
+  EXPECT_EQ(counters.count(-4), 4);
+  EXPECT_EQ(counters.snapshot().size(),
+            threads * per_thread + threads * (threads + 1) / 2);
+}
@@ -0,0 +1,238 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../lace_concurrent_skiplist_map.h"
+#include "../lace_hazard_pointer.h"
+
+using SkipInts = lace::concurrent_skiplist_map<int, int>;
+using HazardSkipInts =
+    lace::concurrent_skiplist_map<int, int, lace::hazard_pointer>;
+
+namespace {
+
+// Inserts, erases and looks up a few keys from several threads while another
+// thread keeps iterating, then checks the counts add up.
+template <typename Map>
+void same_key_insert_erase_stress() {
+  Map m;
+  const int keys = 64;
+  std::atomic<long> inserted{0};
+  std::atomic<long> erased{0};
+  std::vector<std::thread> workers;
+  for (int t = 0; t < 4; ++t) {
+    workers.emplace_back([&, t] {
+      for (int i = 0; i < 5000; ++i) {
+        int key = (i * 7 + t) % keys;
+        if ((i + t) % 2 == 0) {
+          if (m.insert(key, key)) inserted++;
+        } else {
+          if (m.erase(key)) erased++;
+        }
+        auto value = m.get(key);
+        if (value) {
+          EXPECT_EQ(*value, key);
+        }
+      }
+    });
+  }
+  workers.emplace_back([&] {
+    for (int round = 0; round < 200; ++round) {
+      int previous = -1;
+      for (const auto& kv : m) {
+        EXPECT_LT(previous, kv.first);
+        previous = kv.first;
+      }
+    }
+  });
+  for (auto& w : workers) w.join();
+
+  long live = 0;
+  for (auto it = m.begin(); it != m.end(); ++it) live++;
+  EXPECT_EQ(live, inserted - erased);
+  EXPECT_EQ(static_cast<long>(m.size()), live);
+}
+
+}  // namespace
+
+TEST(ConcurrentSkiplistMapTest, BasicOperations) {
+  SkipInts m;
+  EXPECT_TRUE(m.empty());
+  EXPECT_TRUE(m.insert(2, 20));
+  EXPECT_TRUE(m.insert({1, 10}));
+  EXPECT_FALSE(m.insert(2, 21));
+  EXPECT_EQ(m.size(), 2);
+  EXPECT_TRUE(m.contains(1));
+  EXPECT_FALSE(m.contains(3));
+  EXPECT_EQ(m.get(2), 20);
+  EXPECT_EQ(m.get(3), std::nullopt);
+  EXPECT_EQ(m.find(1)->second, 10);
+  EXPECT_EQ(m.find(5), m.end());
+
+  EXPECT_TRUE(m.erase(1));
+  EXPECT_FALSE(m.erase(1));
+  EXPECT_EQ(m.size(), 1);
+  m.clear();
+  EXPECT_TRUE(m.empty());
+  EXPECT_EQ(m.begin(), m.end());
+}
+
+TEST(ConcurrentSkiplistMapTest, OrderedIterationAndBounds) {
+  SkipInts m;
+  for (int i = 99; i >= 0; --i) m.insert(i * 2, i);
+  int expected = 0;
+  for (const auto& kv : m) {
+    EXPECT_EQ(kv.first, expected);
+    EXPECT_EQ(kv.second, expected / 2);
+    expected += 2;
+  }
+  EXPECT_EQ(expected, 200);
+
+  EXPECT_EQ(m.lower_bound(7)->first, 8);
+  EXPECT_EQ(m.lower_bound(8)->first, 8);
+  EXPECT_EQ(m.upper_bound(8)->first, 10);
+  EXPECT_EQ(m.lower_bound(199), m.end());
+  EXPECT_THROW(*m.end(), std::runtime_error);
+}
+
+TEST(ConcurrentSkiplistMapTest, IteratorSurvivesErase) {
+  SkipInts m{{1, 1}, {2, 2}, {3, 3}};
+  auto it = m.find(2);
+  EXPECT_TRUE(m.erase(2));
+  EXPECT_TRUE(m.erase(3));
+  EXPECT_EQ(it->second, 2);
+  ++it;
+  EXPECT_EQ(it, m.end());
+}
+
+TEST(ConcurrentSkiplistMapTest, NonTrivialValues) {
+  lace::concurrent_skiplist_map<std::string, std::string> m;
+  for (int i = 0; i < 100; ++i) {
+    m.insert(std::to_string(i), std::string(50, 'a' + i % 26));
+  }
+  for (int i = 0; i < 100; i += 2) EXPECT_TRUE(m.erase(std::to_string(i)));
+  EXPECT_EQ(m.size(), 50);
+  EXPECT_EQ(m.get("1"), std::string(50, 'b'));
+}
+
+TEST(ConcurrentSkiplistMapTest, ConcurrentDisjointInserts) {
+  SkipInts m;
+  const int threads = 4;
+  const int per_thread = 2000;
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&m, t] {
+      for (int i = 0; i < per_thread; ++i) {
+        EXPECT_TRUE(m.insert(i * threads + t, t));
+      }
+    });
+  }
+  for (auto& w : workers) w.join();
+
+  EXPECT_EQ(m.size(), threads * per_thread);
+  int expected = 0;
+  for (const auto& kv : m) {
+    EXPECT_EQ(kv.first, expected);
+    EXPECT_EQ(kv.second, expected % threads);
+    expected++;
+  }
+  EXPECT_EQ(expected, threads * per_thread);
+}
+
+TEST(ConcurrentSkiplistMapTest, ConcurrentSameKeyInsertEraseStress) {
+  same_key_insert_erase_stress<SkipInts>();
+}
+
+TEST(ConcurrentSkiplistMapTest, EachKeyErasedOnce) {
+  SkipInts m;
+  const int keys = 4000;
+  for (int i = 0; i < keys; ++i) m.insert(i, i);
+  std::atomic<int> erased{0};
+  std::vector<std::thread> workers;
+  for (int t = 0; t < 4; ++t) {
+    workers.emplace_back([&] {
+      for (int i = 0; i < keys; ++i) {
+        if (m.erase(i)) erased++;
+      }
+    });
+  }
+  for (auto& w : workers) w.join();
+  EXPECT_EQ(erased, keys);
+  EXPECT_TRUE(m.empty());
+  EXPECT_EQ(m.begin(), m.end());
+}
+
+TEST(ConcurrentSkiplistMapTest, HazardPointerDomain) {
+  HazardSkipInts m;
+  for (int i = 99; i >= 0; --i) EXPECT_TRUE(m.insert(i * 2, i));
+  EXPECT_FALSE(m.insert(4, 0));
+  EXPECT_EQ(m.size(), 100);
+  int expected = 0;
+  for (const auto& kv : m) {
+    EXPECT_EQ(kv.first, expected);
+    expected += 2;
+  }
+  EXPECT_EQ(expected, 200);
+  EXPECT_EQ(m.get(10), 5);
+  EXPECT_EQ(m.lower_bound(7)->first, 8);
+  EXPECT_EQ(m.upper_bound(8)->first, 10);
+  EXPECT_EQ(m.find(7), m.end());
+  for (int i = 0; i < 200; i += 4) EXPECT_TRUE(m.erase(i));
+  EXPECT_EQ(m.size(), 50);
+  EXPECT_FALSE(m.contains(4));
+  EXPECT_TRUE(m.contains(6));
+  m.clear();
+  EXPECT_TRUE(m.empty());
+  EXPECT_EQ(m.begin(), m.end());
+}
+
+TEST(ConcurrentSkiplistMapTest, HazardPointerIteratorsSurviveErase) {
+  HazardSkipInts m{{1, 1}, {2, 2}, {3, 3}, {4, 4}};
+  auto it = m.find(2);
+  auto copy = it;
+  EXPECT_TRUE(m.erase(2));
+  EXPECT_TRUE(m.erase(3));
+  // Enough retirements to run hazard scans while the iterators hold 2.
+  for (int i = 10; i < 300; ++i) {
+    m.insert(i, i);
+    m.erase(i);
+  }
+  EXPECT_EQ(it->second, 2);
+  EXPECT_EQ(copy->second, 2);
+  ++it;
+  EXPECT_EQ(it->first, 4);
+  // The node is retired by now, so a fresh copy moves on to a live one.
+  auto late = copy;
+  EXPECT_EQ(late->first, 4);
+  it = late;
+  EXPECT_EQ(it, late);
+  ++it;
+  EXPECT_EQ(it, m.end());
+}
+
+TEST(ConcurrentSkiplistMapTest, HazardPointerConcurrentStress) {
+  same_key_insert_erase_stress<HazardSkipInts>();
+}
+
+TEST(ConcurrentSkiplistMapTest, HazardPointerEachKeyErasedOnce) {
+  HazardSkipInts m;
+  const int keys = 4000;
+  for (int i = 0; i < keys; ++i) m.insert(i, i);
+  std::atomic<int> erased{0};
+  std::vector<std::thread> workers;
+  for (int t = 0; t < 4; ++t) {
+    workers.emplace_back([&] {
+      for (int i = 0; i < keys; ++i) {
+        if (m.erase(i)) erased++;
+        m.insert(keys + i, i);
+      }
+    });
+  }
+  for (auto& w : workers) w.join();
+  EXPECT_EQ(erased, keys);
+  EXPECT_EQ(m.size(), keys);
+  EXPECT_EQ(m.begin()->first, keys);
+}
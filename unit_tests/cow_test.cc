@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../lace_cow.h"
+
+namespace {
+
+class CountCopies {
+ public:
+  CountCopies(int v = 0) : value(v) {}
+  CountCopies(const CountCopies& other) : value(other.value) { ++copies; }
+  CountCopies& operator=(const CountCopies& other) = default;
+
+  int value;
+  inline static int copies = 0;
+};
+
+}  // namespace
+
+TEST(CowMapTest, CopiesShareUntilWritten) {
+  lace::cow_map<int, CountCopies> original;
+  for (int i = 0; i < 100; ++i) original.insert(i, CountCopies(i));
+
+  CountCopies::copies = 0;
+  lace::cow_map<int, CountCopies> copy = original;
+  lace::cow_map<int, CountCopies> another(copy);
+  EXPECT_EQ(CountCopies::copies, 0);
+  EXPECT_TRUE(original.shared());
+  EXPECT_EQ(copy.at(42).value, 42);
+  EXPECT_EQ(copy.size(), 100);
+  EXPECT_EQ(CountCopies::copies, 0);
+
+  copy.insert_or_assign(42, CountCopies(-42));
+  EXPECT_GE(CountCopies::copies, 100);
+  EXPECT_LE(CountCopies::copies, 2 * 100 + 2);
+  EXPECT_EQ(copy.at(42).value, -42);
+  EXPECT_EQ(original.at(42).value, 42);
+  EXPECT_EQ(another.at(42).value, 42);
+  EXPECT_FALSE(copy.shared());
+  EXPECT_TRUE(original.shared());
+
+  CountCopies::copies = 0;
+  copy.erase(1);
+  copy[200] = CountCopies(200);
+  EXPECT_LE(CountCopies::copies, 6);
+  EXPECT_EQ(copy.size(), 100);
+  EXPECT_EQ(original.size(), 100);
+}
+
+TEST(CowMapTest, UniqueOwnerWritesInPlace) {
+  lace::cow_map<int, std::string> m = {{1, "one"}, {2, "two"}};
+  EXPECT_FALSE(m.shared());
+  {
+    lace::cow_map<int, std::string> copy(m);
+    EXPECT_TRUE(m.shared());
+  }
+  EXPECT_FALSE(m.shared());
+  const auto* before = &m.base();
+  m.insert(3, "three");
+  m[1] = "uno";
+  EXPECT_EQ(before, &m.base());
+  EXPECT_EQ(m.at(1), "uno");
+}
+
+TEST(CowMapTest, CopyAfterSubscriptDoesNotAlias) {
+  lace::cow_map<int, int> m = {{1, 10}, {2, 20}};
+  int& value = m[1];
+  lace::cow_map<int, int> copy = m;
+  EXPECT_FALSE(m.shared());
+  EXPECT_NE(&m.base(), &copy.base());
+  value = 11;
+  EXPECT_EQ(m.at(1), 11);
+  EXPECT_EQ(copy.at(1), 10);
+
+  lace::cow_map<int, int> assigned;
+  assigned = m;
+  m[2] = 21;
+  EXPECT_EQ(assigned.at(2), 20);
+
+  // A copy that never handed out a reference shares as usual.
+  lace::cow_map<int, int> shared_copy = copy;
+  EXPECT_TRUE(copy.shared());
+}
+
+TEST(CowMapTest, ConstReadsAndIteration) {
+  lace::map<int, int> source;
+  for (int i = 0; i < 10; ++i) source.insert(i, i * i);
+  lace::cow_map<int, int> m(std::move(source));
+  lace::cow_map<int, int> copy = m;
+
+  int expected = 0;
+  for (const auto& kv : copy) {
+    EXPECT_EQ(kv.first, expected);
+    EXPECT_EQ(kv.second, expected * expected);
+    ++expected;
+  }
+  EXPECT_EQ(expected, 10);
+  EXPECT_TRUE(copy.contains(3));
+  EXPECT_EQ(copy.find(11), copy.end());
+  EXPECT_EQ(copy.lower_bound(4)->second, 16);
+  int sum = 0;
+  copy.for_each_in_range(2, 5, [&sum](const auto& kv) { sum += kv.first; });
+  EXPECT_EQ(sum, 9);
+  EXPECT_TRUE(m.shared());
+}
+
+TEST(CowMapTest, AssignmentAndSwap) {
+  lace::cow_map<int, int> a = {{1, 1}};
+  lace::cow_map<int, int> b = {{2, 2}, {3, 3}};
+  a = b;
+  EXPECT_EQ(a.size(), 2);
+  EXPECT_TRUE(b.shared());
+  lace::cow_map<int, int> c = std::move(a);
+  EXPECT_EQ(c.size(), 2);
+  c.clear();
+  EXPECT_TRUE(c.empty());
+  EXPECT_EQ(b.size(), 2);
+  c.swap(b);
+  EXPECT_TRUE(b.empty());
+  EXPECT_EQ(c.size(), 2);
+}
+
+TEST(CowMapTest, CopiesWrittenOnDifferentThreads) {
+  lace::cow_map<int, int> base;
+  for (int i = 0; i < 1000; ++i) base.insert(i, i);
+
+  std::vector<lace::cow_map<int, int>> copies(4, base);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&copies, t] {
+      for (int i = 0; i < 1000; ++i) copies[t][i] += t;
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  for (int t = 0; t < 4; ++t) {
+    EXPECT_EQ(copies[t].at(500), 500 + t);
+  }
+  EXPECT_EQ(base.at(500), 500);
+}
+
+TEST(CowSetTest, CopiesShareUntilWritten) {
+  lace::cow_set<int> original = {1, 2, 3};
+  lace::cow_set<int> copy = original;
+  EXPECT_TRUE(original.shared());
+  EXPECT_EQ(&original.base(), &copy.base());
+
+  EXPECT_TRUE(copy.insert(4).second);
+  EXPECT_FALSE(copy.insert(4).second);
+  copy.erase(1);
+  EXPECT_NE(&original.base(), &copy.base());
+  EXPECT_TRUE(original.contains(1));
+  EXPECT_FALSE(original.contains(4));
+  EXPECT_EQ(copy.size(), 3);
+
+  std::vector<int> keys;
+  for (int key : copy) keys.push_back(key);
+  EXPECT_EQ(keys, std::vector<int>({2, 3, 4}));
+}
@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "../lace_epoch.h"
+
+namespace {
+
+std::atomic<int> live_counters{0};
+
+struct Counted {
+  int value = 42;
+
+  Counted() { live_counters++; }
+  ~Counted() { live_counters--; }
+};
+
+}  // namespace
+
+TEST(EpochTest, RetiredNodesAreFreedOnceUnpinned) {
+  live_counters = 0;
+  lace::epoch domain;
+  {
+    auto guard = domain.pin();
+    auto nested = guard;
+    for (int i = 0; i < 10; ++i) domain.retire(new Counted());
+    domain.reclaim();
+    EXPECT_EQ(live_counters, 10);
+    EXPECT_EQ(domain.garbage_size(), 10);
+  }
+  domain.reclaim();
+  EXPECT_EQ(live_counters, 0);
+  EXPECT_EQ(domain.garbage_size(), 0);
+}
+
+TEST(EpochTest, PinnedThreadHoldsBackOthers) {
+  live_counters = 0;
+  lace::epoch domain;
+  std::atomic<bool> pinned{false};
+  std::atomic<bool> release{false};
+  std::thread reader([&] {
+    auto guard = domain.pin();
+    pinned = true;
+    while (!release) std::this_thread::yield();
+  });
+  while (!pinned) std::this_thread::yield();
+
+  domain.retire(new Counted());
+  domain.reclaim();
+  EXPECT_EQ(live_counters, 1);
+
+  release = true;
+  reader.join();
+  domain.reclaim();
+  EXPECT_EQ(live_counters, 0);
+}
+
+TEST(EpochTest, GarbageIsBatchedAndBounded) {
+  live_counters = 0;
+  lace::epoch domain(256);
+  EXPECT_EQ(domain.max_garbage(), 256);
+  for (int i = 0; i < 10000; ++i) {
+    domain.retire(new Counted());
+    EXPECT_LT(domain.garbage_size(), 256);
+  }
+  {
+    auto guard = domain.pin();
+    for (int i = 0; i < 1000; ++i) domain.retire(new Counted());
+    EXPECT_GE(live_counters, 1000);
+  }
+  EXPECT_LE(live_counters, 256);
+  domain.synchronize();
+  EXPECT_EQ(live_counters, 0);
+}
+
+TEST(EpochTest, SynchronizeWhilePinnedThrows) {
+  lace::epoch domain;
+  auto guard = domain.pin();
+  EXPECT_THROW(domain.synchronize(), std::logic_error);
+}
+
+TEST(EpochTest, ExitedThreadGarbageIsAdopted) {
+  live_counters = 0;
+  lace::epoch domain;
+  std::thread worker([&] {
+    for (int i = 0; i < 10; ++i) domain.retire(new Counted());
+  });
+  worker.join();
+  EXPECT_EQ(domain.garbage_size(), 10);
+  domain.reclaim();
+  domain.reclaim();
+  EXPECT_EQ(live_counters, 0);
+}
+
+TEST(EpochTest, DestructionFreesEverything) {
+  live_counters = 0;
+  {
+    lace::epoch domain;
+    auto guard = domain.pin();
+    for (int i = 0; i < 100; ++i) domain.retire(new Counted());
+  }
+  EXPECT_EQ(live_counters, 0);
+}
+
+TEST(EpochTest, ConcurrentPublishAndRead) {
+  live_counters = 0;
+  {
+    lace::epoch domain;
+    std::atomic<Counted*> shared{new Counted()};
+    std::atomic<bool> done{false};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 3; ++t) {
+      threads.emplace_back([&] {
+        while (!done) {
+          auto guard = domain.pin();
+          EXPECT_EQ(shared.load()->value, 42);
+        }
+      });
+    }
+    for (int i = 0; i < 5000; ++i) {
+      domain.retire(shared.exchange(new Counted()));
+    }
+    done = true;
+    for (auto& thread : threads) thread.join();
+    delete shared.load();
+  }
+  EXPECT_EQ(live_counters, 0);
+}
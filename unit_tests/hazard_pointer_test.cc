@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "../lace_hazard_pointer.h"
+
+namespace {
+
+std::atomic<int> live_nodes{0};
+
+struct Node {
+  int value;
+  Node* next = nullptr;
+
+  explicit Node(int v) : value(v) { live_nodes++; }
+  ~Node() { live_nodes--; }
+};
+
+// Treiber stack whose pop protects the head with a hazard pointer.
+class Stack {
+ public:
+  explicit Stack(lace::hazard_pointer& domain) : domain_(domain) {}
+
+  ~Stack() {
+    Node* node = head_.load();
+    while (node != nullptr) {
+      Node* next = node->next;
+      delete node;
+      node = next;
+    }
+  }
+
+  void push(int value) {
+    Node* node = new Node(value);
+    node->next = head_.load();
+    while (!head_.compare_exchange_weak(node->next, node)) {
+    }
+  }
+
+  bool pop(int& value) {
+    auto guard = domain_.make_guard();
+    while (true) {
+      Node* head = guard.protect(head_);
+      if (head == nullptr) return false;
+      Node* next = head->next;
+      if (head_.compare_exchange_strong(head, next)) {
+        value = head->value;
+        guard.reset();
+        domain_.retire(head);
+        return true;
+      }
+    }
+  }
+
+ private:
+  lace::hazard_pointer& domain_;
+  std::atomic<Node*> head_{nullptr};
+};
+
+}  // namespace
+
+TEST(HazardPointerTest, ProtectedNodeSurvivesReclaim) {
+  live_nodes = 0;
+  lace::hazard_pointer domain;
+  std::atomic<Node*> shared{new Node(1)};
+  {
+    auto guard = domain.make_guard();
+    Node* node = guard.protect(shared);
+    domain.retire(shared.exchange(nullptr));
+    domain.retire(new Node(2));
+    domain.reclaim();
+    EXPECT_EQ(live_nodes, 1);
+    EXPECT_EQ(node->value, 1);
+    EXPECT_EQ(domain.garbage_size(), 1);
+  }
+  domain.reclaim();
+  EXPECT_EQ(live_nodes, 0);
+  EXPECT_EQ(domain.garbage_size(), 0);
+}
+
+TEST(HazardPointerTest, SlotsAreLimited) {
+  lace::hazard_pointer domain;
+  std::vector<lace::hazard_pointer::guard> guards;
+  for (size_t i = 0; i < lace::hazard_pointer::kSlotsPerThread; ++i) {
+    guards.push_back(domain.make_guard());
+  }
+  EXPECT_THROW(domain.make_guard(), std::length_error);
+  guards.pop_back();
+  EXPECT_NO_THROW(domain.make_guard());
+}
+
+TEST(HazardPointerTest, StalledReaderKeepsGarbageBounded) {
+  live_nodes = 0;
+  lace::hazard_pointer domain;
+  std::atomic<Node*> shared{new Node(0)};
+  std::atomic<bool> protecting{false};
+  std::atomic<bool> release{false};
+  std::thread reader([&] {
+    auto guard = domain.make_guard();
+    guard.protect(shared);
+    protecting = true;
+    while (!release) std::this_thread::yield();
+  });
+  while (!protecting) std::this_thread::yield();
+
+  for (int i = 1; i <= 10000; ++i) {
+    domain.retire(shared.exchange(new Node(i)));
+    EXPECT_LE(domain.garbage_size(), domain.scan_threshold());
+  }
+  EXPECT_LE(live_nodes, static_cast<int>(domain.scan_threshold()) + 1);
+
+  release = true;
+  reader.join();
+  domain.reclaim();
+  EXPECT_EQ(live_nodes, 1);
+  delete shared.load();
+}
+
+TEST(HazardPointerTest, ExitedThreadGarbageIsAdopted) {
+  live_nodes = 0;
+  lace::hazard_pointer domain;
+  std::thread worker([&] {
+    for (int i = 0; i < 10; ++i) domain.retire(new Node(i));
+  });
+  worker.join();
+  EXPECT_EQ(domain.garbage_size(), 10);
+  domain.reclaim();
+  EXPECT_EQ(live_nodes, 0);
+}
+
+TEST(HazardPointerTest, ConcurrentStackStress) {
+  live_nodes = 0;
+  {
+    lace::hazard_pointer domain;
+    Stack stack(domain);
+    std::atomic<long> pushed{0};
+    std::atomic<long> popped{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+      threads.emplace_back([&, t] {
+        for (int i = 0; i < 5000; ++i) {
+          if ((i + t) % 2 == 0) {
+            stack.push(i);
+            pushed += i;
+          } else {
+            int value;
+            if (stack.pop(value)) popped += value;
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) thread.join();
+    int value;
+    while (stack.pop(value)) popped += value;
+    EXPECT_EQ(pushed, popped);
+  }
+  EXPECT_EQ(live_nodes, 0);
+}
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "../lace_intrusive_queue.h"
+
+namespace {
+
+struct event {
+  int producer = 0;
+  int sequence = 0;
+  lace::intrusive_hook<event> hook;
+  lace::intrusive_hook<event> other_hook;
+};
+
+using event_queue = lace::intrusive_queue<event, &event::hook>;
+using event_mpsc_queue = lace::intrusive_mpsc_queue<event, &event::hook>;
+
+}  // namespace
+
+TEST(IntrusiveQueueTest, FifoWithoutCopies) {
+  std::vector<event> events(5);
+  event_queue q;
+  EXPECT_TRUE(q.empty());
+  EXPECT_EQ(q.pop(), nullptr);
+  for (int i = 0; i < 5; ++i) {
+    events[i].sequence = i;
+    q.push(events[i]);
+  }
+  EXPECT_EQ(q.size(), 5);
+  EXPECT_EQ(q.front(), &events[0]);
+  EXPECT_EQ(q.back(), &events[4]);
+  for (int i = 0; i < 5; ++i) EXPECT_EQ(q.pop(), &events[i]);
+  EXPECT_TRUE(q.empty());
+  EXPECT_EQ(q.back(), nullptr);
+  q.push(events[2]);
+  EXPECT_EQ(q.pop(), &events[2]);
+}
+
+TEST(IntrusiveQueueTest, AppendMoveAndSecondHook) {
+  std::vector<event> events(6);
+  event_queue a;
+  event_queue b;
+  lace::intrusive_queue<event, &event::other_hook> all;
+  for (int i = 0; i < 6; ++i) {
+    (i < 3 ? a : b).push(events[i]);
+    all.push(events[5 - i]);
+  }
+  a.append(b);
+  EXPECT_TRUE(b.empty());
+  EXPECT_EQ(a.size(), 6);
+  event_queue moved(std::move(a));
+  EXPECT_TRUE(a.empty());
+  b = std::move(moved);
+  for (int i = 0; i < 6; ++i) {
+    EXPECT_EQ(b.pop(), &events[i]);
+    EXPECT_EQ(all.pop(), &events[5 - i]);
+  }
+  EXPECT_TRUE(b.empty());
+  EXPECT_TRUE(all.empty());
+}
+
+TEST(IntrusiveQueueTest, MpscKeepsEachProducersOrder) {
+  const int producers = 3;
+  const int count = 20000;
+  std::vector<std::vector<event>> events(producers,
+                                         std::vector<event>(count));
+  event_mpsc_queue q;
+  EXPECT_TRUE(q.empty());
+  EXPECT_EQ(q.pop(), nullptr);
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; ++p) {
+    threads.emplace_back([&, p] {
+      for (int i = 0; i < count; ++i) {
+        events[p][i].producer = p;
+        events[p][i].sequence = i;
+        q.push(events[p][i]);
+      }
+    });
+  }
+  std::vector<int> next(producers, 0);
+  int received = 0;
+  while (received < producers * count) {
+    if (received % 1000 == 0) {
+      event_queue batch = q.pop_all();
+      while (event* e = batch.pop()) {
+        ASSERT_EQ(e->sequence, next[e->producer]++);
+        ++received;
+      }
+    }
+    if (event* e = q.pop()) {
+      ASSERT_EQ(e->sequence, next[e->producer]++);
+      ++received;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  for (auto& thread : threads) thread.join();
+  EXPECT_TRUE(q.empty());
+  for (int p = 0; p < producers; ++p) EXPECT_EQ(next[p], count);
+}
@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../lace_mpmc_queue.h"
+
+TEST(MpmcQueueTest, FifoWithinCapacity) {
+  lace::mpmc_queue<int> q(3);
+  EXPECT_EQ(q.capacity(), 4);
+  int out = 0;
+  EXPECT_FALSE(q.try_pop(out));
+  for (int i = 0; i < 4; ++i) EXPECT_TRUE(q.try_push(i));
+  EXPECT_FALSE(q.try_push(4));
+  EXPECT_EQ(q.size(), 4);
+  for (int lap = 0; lap < 10; ++lap) {
+    EXPECT_TRUE(q.try_pop(out));
+    EXPECT_EQ(out, lap);
+    q.push(lap + 4);
+  }
+  q.pop(out);
+  EXPECT_EQ(out, 10);
+}
+
+TEST(MpmcQueueTest, MoveOnlyAndLeftovers) {
+  auto tracked = std::make_shared<int>(1);
+  {
+    lace::mpmc_queue<std::unique_ptr<std::shared_ptr<int>>> q(8);
+    for (int i = 0; i < 5; ++i) {
+      EXPECT_TRUE(q.try_emplace(new std::shared_ptr<int>(tracked)));
+    }
+    std::unique_ptr<std::shared_ptr<int>> out;
+    q.pop(out);
+    EXPECT_EQ(**out, 1);
+  }
+  EXPECT_EQ(tracked.use_count(), 1);
+}
+
+namespace {
+
+// Construction from a negative number throws; moves never do.
+struct picky {
+  std::string text;
+
+  explicit picky(int n) : text(std::to_string(n)) {
+    if (n < 0) throw std::invalid_argument("negative");
+  }
+};
+
+// Copy-assigning from a value marked bad throws.
+struct fragile {
+  bool bad = false;
+
+  fragile() = default;
+  explicit fragile(bool b) : bad(b) {}
+  fragile(const fragile&) = default;
+  fragile& operator=(const fragile&) = default;
+  fragile(fragile&&) noexcept = default;
+  fragile& operator=(fragile&& other) {
+    if (other.bad) throw std::runtime_error("bad move");
+    bad = other.bad;
+    return *this;
+  }
+};
+
+}  // namespace
+
+TEST(MpmcQueueTest, ThrowingConstructionAndMoveKeepQueueUsable) {
+  lace::mpmc_queue<picky> q(2);
+  EXPECT_TRUE(q.try_emplace(1));
+  EXPECT_THROW(q.try_emplace(-1), std::invalid_argument);
+  EXPECT_TRUE(q.try_emplace(2));
+  EXPECT_FALSE(q.try_emplace(3));
+  picky out(0);
+  q.pop(out);
+  EXPECT_EQ(out.text, "1");
+  q.pop(out);
+  EXPECT_EQ(out.text, "2");
+  EXPECT_TRUE(q.empty());
+
+  lace::mpmc_queue<fragile> f(2);
+  EXPECT_TRUE(f.try_emplace(true));
+  EXPECT_TRUE(f.try_emplace(false));
+  fragile value;
+  EXPECT_THROW(f.try_pop(value), std::runtime_error);
+  // The slot of the lost element was released.
+  EXPECT_TRUE(f.try_pop(value));
+  EXPECT_TRUE(f.try_emplace(false));
+  EXPECT_TRUE(f.try_emplace(false));
+  EXPECT_FALSE(f.try_emplace(false));
+}
+
+TEST(MpmcQueueTest, RejectsCapacityPastMax) {
+  using queue = lace::mpmc_queue<int>;
+  EXPECT_EQ(queue(0).capacity(), 2);
+  EXPECT_THROW(queue(queue::max_capacity() + 1), std::length_error);
+  EXPECT_THROW(queue(SIZE_MAX), std::length_error);
+}
+
+TEST(MpmcQueueTest, ManyProducersManyConsumers) {
+  lace::mpmc_queue<long> q(64);
+  const int producers = 3;
+  const int consumers = 3;
+  const long per_producer = 30000;
+  std::atomic<long> sum{0};
+  std::atomic<long> received{0};
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; ++p) {
+    threads.emplace_back([&q, p] {
+      for (long i = 0; i < per_producer; ++i) q.push(p * per_producer + i);
+    });
+  }
+  for (int c = 0; c < consumers; ++c) {
+    threads.emplace_back([&] {
+      long value;
+      long last_seen[producers] = {-1, -1, -1};
+      while (received.load() < producers * per_producer) {
+        if (!q.try_pop(value)) {
+          std::this_thread::yield();
+          continue;
+        }
+        received++;
+        sum += value;
+        // Items from one producer reach any one consumer in order.
+        long producer = value / per_producer;
+        EXPECT_LT(last_seen[producer], value);
+        last_seen[producer] = value;
+      }
+    });
+  }
+  for (auto& t : threads) t.join();
+  long total = producers * per_producer;
+  EXPECT_EQ(sum, total * (total - 1) / 2);
+  EXPECT_TRUE(q.empty());
+}
@@ -4,6 +4,7 @@
 #include <utility>
 
 #include "../lace_multiset.h"
+#include "../lace_parallel.h"
 
 // заменить на lace::multiset
 using MultisetInts = lace::multiset<int>;
@@ -626,4 +627,47 @@ TEST(MultisetTest, BoundaryCases) {
 
   lace::multiset<int> same_ms = {5, 5, 5};
   EXPECT_EQ(same_ms.count(5), 3);
-}
\ No newline at end of file
+}
+
+TEST(MultisetTest, ForEachInRange) {
+  lace::multiset<int> ms = {1, 2, 2, 3, 3, 3, 4};
+  std::vector<int> visited;
+  ms.for_each_in_range(2, 4, [&visited](int key) { visited.push_back(key); });
+  EXPECT_EQ(visited, std::vector<int>({2, 2, 3, 3, 3}));
+
+  visited.clear();
+  ms.for_each_in_range(2, 4, [&visited](int key) {
+    visited.push_back(key);
+    return visited.size() < 3;
+  });
+  EXPECT_EQ(visited, std::vector<int>({2, 2, 3}));
+}
+
+TEST(MultisetTest, BuildParallel) {
+  std::vector<int> keys;
+  for (int i = 0; i < 50000; ++i) keys.push_back(i % 1000);
+  auto ms =
+      lace::build_parallel<lace::multiset<int>>(keys.begin(), keys.end(), 4);
+  EXPECT_EQ(ms.size(), 50000);
+  EXPECT_EQ(ms.count(0), 50);
+  EXPECT_EQ(ms.count(999), 50);
+  EXPECT_EQ(ms.count(1000), 0);
+  ms.insert(5);
+  EXPECT_EQ(ms.count(5), 51);
+}
+
+TEST(MultisetTest, InsertWithCountAndFromCounts) {
+  MultisetInts ms;
+  EXPECT_EQ(*ms.insert(4, 3), 4);
+  EXPECT_EQ(ms.insert(6, 0), ms.end());
+  ms.insert(4, 2);
+  EXPECT_EQ(ms.count(4), 5);
+  EXPECT_EQ(ms.size(), 5);
+
+  auto built = MultisetInts::from_counts({{1, 2}, {3, 1}, {8, 4}});
+  EXPECT_EQ(built.size(), 7);
+  EXPECT_EQ(built.count(8), 4);
+  std::vector<int> keys;
+  for (int key : built) keys.push_back(key);
+  EXPECT_EQ(keys, std::vector<int>({1, 1, 3, 8, 8, 8, 8}));
+}
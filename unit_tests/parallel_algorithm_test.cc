@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "../lace_parallel.h"
+#include "../lace_set.h"
+
+namespace {
+
+lace::map<int, int> make_map(int size) {
+  std::vector<std::pair<int, int>> items;
+  for (int i = 0; i < size; ++i) items.emplace_back(i, i % 7);
+  return lace::map<int, int>::from_sorted(items.begin(), items.end());
+}
+
+}  // namespace
+
+TEST(ParallelAlgorithmTest, SplitCoversTreeInRoughlyEqualRuns) {
+  auto m = make_map(100000);
+  auto bounds = m.split(16);
+  ASSERT_GE(bounds.size(), 3);
+  EXPECT_EQ(bounds.front(), m.begin());
+  EXPECT_EQ(bounds.back(), m.end());
+
+  size_t total = 0;
+  int expected = 0;
+  for (size_t i = 0; i + 1 < bounds.size(); ++i) {
+    size_t run = 0;
+    for (auto it = bounds[i]; it != bounds[i + 1]; ++it, ++run) {
+      EXPECT_EQ(it->first, expected++);
+    }
+    EXPECT_GT(run, 0);
+    EXPECT_LT(run, 3 * m.size() / 16);
+    total += run;
+  }
+  EXPECT_EQ(total, m.size());
+
+  EXPECT_EQ(m.split(1).size(), 2);
+  lace::map<int, int> empty;
+  auto none = empty.split(8);
+  ASSERT_EQ(none.size(), 2);
+  EXPECT_EQ(none.front(), none.back());
+}
+
+TEST(ParallelAlgorithmTest, ForEachVisitsEveryElementOnce) {
+  auto m = make_map(100000);
+  std::vector<std::atomic<int>> seen(m.size());
+  lace::parallel_for_each(
+      m, [&seen](const auto& kv) { seen[kv.first]++; }, 4);
+  for (const auto& count : seen) EXPECT_EQ(count.load(), 1);
+
+  lace::set<int> s{1, 2, 3};
+  std::atomic<int> sum{0};
+  lace::parallel_for_each(s, [&sum](int key) { sum += key; });
+  EXPECT_EQ(sum, 6);
+}
+
+TEST(ParallelAlgorithmTest, ReduceMatchesSequential) {
+  auto m = make_map(100000);
+  long expected = 0;
+  for (const auto& kv : m) expected += kv.second;
+  for (unsigned threads : {1u, 2u, 4u, 8u}) {
+    long sum = lace::parallel_reduce(
+        m, 0L, [](long acc, const auto& kv) { return acc + kv.second; },
+        std::plus<long>(), threads);
+    EXPECT_EQ(sum, expected);
+  }
+
+  lace::set<int> s;
+  for (int i = 1; i <= 50000; ++i) s.insert(i);
+  EXPECT_EQ(lace::parallel_reduce(s, 0L, std::plus<>()), 50000L * 50001 / 2);
+
+  lace::set<int> empty;
+  EXPECT_EQ(lace::parallel_reduce(empty, 5, std::plus<>()), 5);
+}
+
+TEST(ParallelAlgorithmTest, ReduceToBool) {
+  auto m = make_map(100000);
+  auto all_small = [](bool acc, const auto& kv) {
+    return acc && kv.second < 7;
+  };
+  auto any_six = [](bool acc, const auto& kv) {
+    return acc || kv.second == 6;
+  };
+  for (unsigned threads : {1u, 2u, 4u, 8u}) {
+    EXPECT_TRUE(lace::parallel_reduce(m, true, all_small,
+                                      std::logical_and<>(), threads));
+    EXPECT_TRUE(lace::parallel_reduce_ordered(m, false, any_six,
+                                              std::logical_or<>(), threads));
+    EXPECT_FALSE(lace::parallel_reduce(
+        m, false, [](bool acc, const auto& kv) { return acc || kv.first < 0; },
+        std::logical_or<>(), threads));
+  }
+}
+
+TEST(ParallelAlgorithmTest, OrderedReduceKeepsKeyOrder) {
+  auto m = make_map(60000);
+  for (unsigned threads : {1u, 3u, 4u}) {
+    auto keys = lace::parallel_reduce_ordered(
+        m, std::vector<int>(),
+        [](std::vector<int> acc, const auto& kv) {
+          acc.push_back(kv.first);
+          return acc;
+        },
+        [](std::vector<int> lhs, std::vector<int> rhs) {
+          lhs.insert(lhs.end(), rhs.begin(), rhs.end());
+          return lhs;
+        },
+        threads);
+    ASSERT_EQ(keys.size(), m.size());
+    for (int i = 0; i < static_cast<int>(keys.size()); ++i) {
+      EXPECT_EQ(keys[i], i);
+    }
+  }
+
+  lace::set<std::string> words{"b", "d", "a", "c"};
+  EXPECT_EQ(lace::parallel_reduce_ordered(words, std::string(), std::plus<>()),
+            "abcd");
+}
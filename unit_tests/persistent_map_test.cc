@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../lace_persistent_map.h"
+
+using PersistentInts = lace::persistent_map<int, int>;
+
+namespace {
+
+class CountCopies {
+ public:
+  CountCopies(int v = 0) : value(v) {}
+  CountCopies(const CountCopies& other) : value(other.value) { ++copies; }
+  CountCopies& operator=(const CountCopies& other) = default;
+
+  int value;
+  inline static int copies = 0;
+};
+
+std::vector<int> keys_of(const PersistentInts& m) {
+  std::vector<int> keys;
+  for (const auto& kv : m) keys.push_back(kv.first);
+  return keys;
+}
+
+}  // namespace
+
+TEST(PersistentMapTest, EmptyMap) {
+  PersistentInts m;
+  EXPECT_TRUE(m.empty());
+  EXPECT_EQ(m.size(), 0);
+  EXPECT_EQ(m.begin(), m.end());
+  EXPECT_FALSE(m.contains(1));
+  EXPECT_THROW(m.at(1), std::out_of_range);
+}
+
+TEST(PersistentMapTest, InsertFindErase) {
+  lace::persistent_map<int, std::string> m = {{2, "two"}, {1, "one"}};
+  EXPECT_TRUE(m.insert(3, "three"));
+  EXPECT_FALSE(m.insert(3, "drei"));
+  EXPECT_EQ(m.at(3), "three");
+  EXPECT_FALSE(m.insert_or_assign(3, "drei"));
+  EXPECT_EQ(m.at(3), "drei");
+  EXPECT_EQ(m.size(), 3);
+  EXPECT_EQ(m.find(2)->second, "two");
+  EXPECT_EQ(m.find(4), m.end());
+  ASSERT_NE(m.lookup(1), nullptr);
+  EXPECT_EQ(*m.lookup(1), "one");
+  EXPECT_EQ(m.lookup(4), nullptr);
+
+  EXPECT_TRUE(m.erase(2));
+  EXPECT_FALSE(m.erase(2));
+  EXPECT_EQ(m.size(), 2);
+  EXPECT_FALSE(m.contains(2));
+}
+
+TEST(PersistentMapTest, SnapshotIsUnaffectedByUpdates) {
+  PersistentInts m;
+  for (int i = 0; i < 100; ++i) m.insert(i, i);
+  PersistentInts snap = m.snapshot();
+
+  for (int i = 0; i < 100; i += 2) m.erase(i);
+  for (int i = 100; i < 150; ++i) m.insert(i, -i);
+  m.insert_or_assign(1, 1000);
+
+  EXPECT_EQ(snap.size(), 100);
+  for (int i = 0; i < 100; ++i) EXPECT_EQ(snap.at(i), i);
+  EXPECT_FALSE(snap.contains(120));
+
+  EXPECT_EQ(m.size(), 100);
+  EXPECT_EQ(m.at(1), 1000);
+  EXPECT_FALSE(m.contains(0));
+  EXPECT_EQ(m.at(149), -149);
+  EXPECT_TRUE(m.is_balanced());
+  EXPECT_TRUE(snap.is_balanced());
+}
+
+TEST(PersistentMapTest, UpdatesCopyOnlyAPath) {
+  lace::persistent_map<int, CountCopies> m;
+  for (int i = 0; i < 1024; ++i) m.insert(i, CountCopies(i));
+  auto snap = m.snapshot();
+
+  CountCopies::copies = 0;
+  m.insert_or_assign(511, CountCopies(-1));
+  EXPECT_LE(CountCopies::copies, 3 * 12);
+
+  CountCopies::copies = 0;
+  m.erase(100);
+  EXPECT_LE(CountCopies::copies, 3 * 12);
+
+  CountCopies::copies = 0;
+  auto other = m.snapshot();
+  EXPECT_EQ(CountCopies::copies, 0);
+
+  EXPECT_EQ(snap.at(511).value, 511);
+  EXPECT_EQ(m.at(511).value, -1);
+  EXPECT_EQ(other.size(), 1023);
+}
+
+TEST(PersistentMapTest, IterationIsOrdered) {
+  PersistentInts m;
+  std::map<int, int> reference;
+  std::mt19937 gen(28);
+  std::uniform_int_distribution<int> dist(-500, 500);
+  for (int i = 0; i < 2000; ++i) {
+    int key = dist(gen);
+    if (i % 3 == 0) {
+      EXPECT_EQ(m.erase(key), reference.erase(key) == 1);
+    } else {
+      EXPECT_EQ(m.insert(key, i), reference.insert({key, i}).second);
+    }
+  }
+  ASSERT_EQ(m.size(), reference.size());
+  auto it = m.begin();
+  for (const auto& kv : reference) {
+    ASSERT_NE(it, m.end());
+    EXPECT_EQ(it->first, kv.first);
+    EXPECT_EQ(it->second, kv.second);
+    ++it;
+  }
+  EXPECT_EQ(it, m.end());
+  EXPECT_TRUE(m.is_balanced());
+}
+
+TEST(PersistentMapTest, LowerBound) {
+  PersistentInts m = {{10, 0}, {20, 0}, {30, 0}};
+  EXPECT_EQ(m.lower_bound(5)->first, 10);
+  EXPECT_EQ(m.lower_bound(20)->first, 20);
+  auto it = m.lower_bound(21);
+  EXPECT_EQ(it->first, 30);
+  EXPECT_EQ(++it, m.end());
+  EXPECT_EQ(m.lower_bound(31), m.end());
+}
+
+TEST(PersistentMapTest, BuildFromMap) {
+  lace::map<int, int> source;
+  for (int i = 0; i < 500; ++i) source.insert(i * 2, i);
+  PersistentInts m(source);
+  EXPECT_EQ(m.size(), 500);
+  EXPECT_TRUE(m.is_balanced());
+  std::vector<int> keys = keys_of(m);
+  for (int i = 0; i < 500; ++i) EXPECT_EQ(keys[i], i * 2);
+  source.erase(0);
+  EXPECT_TRUE(m.contains(0));
+}
+
+TEST(PersistentMapTest, CopyMoveSwap) {
+  PersistentInts a = {{1, 1}, {2, 2}};
+  PersistentInts b(a);
+  b.insert(3, 3);
+  EXPECT_EQ(a.size(), 2);
+  EXPECT_EQ(b.size(), 3);
+
+  PersistentInts c(std::move(b));
+  EXPECT_TRUE(b.empty());
+  EXPECT_EQ(keys_of(c), std::vector<int>({1, 2, 3}));
+
+  a.swap(c);
+  EXPECT_EQ(a.size(), 3);
+  EXPECT_EQ(c.size(), 2);
+  c = a;
+  EXPECT_EQ(keys_of(c), std::vector<int>({1, 2, 3}));
+  c.clear();
+  EXPECT_TRUE(c.empty());
+  EXPECT_EQ(a.size(), 3);
+}
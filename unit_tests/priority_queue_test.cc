@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "../lace_priority_queue.h"
+
+namespace {
+
+template <size_t Arity>
+void expect_matches_std(unsigned seed) {
+  std::mt19937 rng(seed);
+  std::vector<int> initial(300);
+  for (int& value : initial) value = static_cast<int>(rng() % 1000);
+  lace::priority_queue<int, std::less<int>, Arity> q(initial.begin(),
+                                                     initial.end());
+  std::priority_queue<int> expected(initial.begin(), initial.end());
+  for (int step = 0; step < 5000; ++step) {
+    if (rng() % 3 != 0 || expected.empty()) {
+      int value = static_cast<int>(rng() % 1000);
+      q.push(value);
+      expected.push(value);
+    } else {
+      q.pop();
+      expected.pop();
+    }
+    ASSERT_EQ(q.size(), expected.size());
+    if (!expected.empty()) {
+      ASSERT_EQ(q.top(), expected.top());
+    }
+  }
+}
+
+struct by_pointee {
+  bool operator()(const std::unique_ptr<int>& a,
+                  const std::unique_ptr<int>& b) const {
+    return *a < *b;
+  }
+};
+
+}  // namespace
+
+TEST(PriorityQueueTest, MatchesStdForEveryArity) {
+  expect_matches_std<2>(1);
+  expect_matches_std<3>(2);
+  expect_matches_std<4>(3);
+  expect_matches_std<8>(4);
+}
+
+TEST(PriorityQueueTest, ComparatorsAndMoveOnlyValues) {
+  lace::priority_queue<int, std::greater<int>> min_heap{5, 1, 4, 2, 3};
+  for (int i = 1; i <= 5; ++i) {
+    EXPECT_EQ(min_heap.top(), i);
+    min_heap.pop();
+  }
+  EXPECT_TRUE(min_heap.empty());
+  EXPECT_THROW(min_heap.top(), std::out_of_range);
+  EXPECT_THROW(min_heap.pop(), std::out_of_range);
+
+  lace::priority_queue<std::unique_ptr<int>, by_pointee> owners;
+  for (int i : {3, 9, 1, 7}) owners.push(std::make_unique<int>(i));
+  owners.emplace(new int(5));
+  EXPECT_EQ(*owners.top(), 9);
+  owners.pop();
+  EXPECT_EQ(*owners.top(), 7);
+  EXPECT_EQ(owners.size(), 4);
+}
+
+TEST(IndexedPriorityQueueTest, DecreaseKeyUpdateAndErase) {
+  std::mt19937 rng(7);
+  lace::indexed_priority_queue<int, std::greater<int>> q;
+  std::map<size_t, int> expected;
+  for (int step = 0; step < 5000; ++step) {
+    unsigned op = rng() % 5;
+    if (op < 2 || expected.empty()) {
+      int value = static_cast<int>(rng() % 1000);
+      size_t h = q.push(value);
+      EXPECT_FALSE(expected.count(h));
+      expected[h] = value;
+    } else {
+      auto it = expected.begin();
+      std::advance(it, rng() % expected.size());
+      if (op == 2) {
+        it->second -= static_cast<int>(rng() % 50);
+        q.promote(it->first, it->second);
+      } else if (op == 3) {
+        it->second = static_cast<int>(rng() % 1000);
+        q.update(it->first, it->second);
+      } else {
+        q.erase(it->first);
+        EXPECT_FALSE(q.contains(it->first));
+        expected.erase(it);
+      }
+    }
+    ASSERT_EQ(q.size(), expected.size());
+    if (expected.empty()) continue;
+    int smallest = expected.begin()->second;
+    for (const auto& [h, value] : expected) {
+      ASSERT_EQ(q.value(h), value);
+      smallest = std::min(smallest, value);
+    }
+    ASSERT_EQ(q.top(), smallest);
+    ASSERT_EQ(expected.at(q.top_handle()), smallest);
+  }
+}
+
+TEST(IndexedPriorityQueueTest, RejectsStaleHandlesAndWrongDirection) {
+  lace::indexed_priority_queue<int, std::greater<int>> q;
+  size_t a = q.push(10);
+  size_t b = q.push(20);
+  EXPECT_THROW(q.promote(a, 11), std::invalid_argument);
+  q.promote(b, 5);
+  EXPECT_EQ(q.top_handle(), b);
+  q.pop();
+  EXPECT_FALSE(q.contains(b));
+  EXPECT_THROW(q.erase(b), std::out_of_range);
+  EXPECT_THROW(q.value(42), std::out_of_range);
+  // The freed handle is handed out again.
+  EXPECT_EQ(q.push(1), b);
+  EXPECT_EQ(q.top_handle(), b);
+  q.clear();
+  EXPECT_TRUE(q.empty());
+  EXPECT_THROW(q.top(), std::out_of_range);
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "../lace_rcu_map.h"
+
+using RcuInts = lace::rcu_map<int, int>;
+
+TEST(RcuMapTest, WritesAreVisibleToNewPins) {
+  RcuInts m;
+  auto reader = m.make_reader();
+  EXPECT_TRUE(reader.pin()->empty());
+
+  EXPECT_TRUE(m.insert(1, 10));
+  EXPECT_FALSE(m.insert(1, 11));
+  EXPECT_TRUE(m.insert_or_assign(2, 20));
+  {
+    auto guard = reader.pin();
+    EXPECT_EQ(guard->size(), 2);
+    EXPECT_EQ(guard->at(1), 10);
+    EXPECT_EQ((*guard).at(2), 20);
+  }
+  EXPECT_TRUE(m.erase(1));
+  EXPECT_FALSE(m.erase(1));
+  EXPECT_FALSE(reader.pin()->contains(1));
+  m.clear();
+  EXPECT_TRUE(reader.pin()->empty());
+}
+
+TEST(RcuMapTest, PinnedVersionStaysStable) {
+  RcuInts m;
+  m.insert(1, 1);
+  auto reader = m.make_reader();
+  auto guard = reader.pin();
+
+  m.insert_or_assign(1, 2);
+  m.insert(3, 3);
+  EXPECT_EQ(guard->at(1), 1);
+  EXPECT_FALSE(guard->contains(3));
+  EXPECT_EQ(m.retired_count(), 2);
+
+  auto fresh_reader = m.make_reader();
+  EXPECT_EQ(fresh_reader.pin()->at(1), 2);
+}
+
+TEST(RcuMapTest, VersionsAreReclaimedAfterUnpin) {
+  RcuInts m;
+  auto reader = m.make_reader();
+  {
+    auto guard = reader.pin();
+    auto nested = reader.pin();
+    for (int i = 0; i < 10; ++i) m.insert(i, i);
+    EXPECT_EQ(m.retired_count(), 10);
+  }
+  m.reclaim();
+  EXPECT_EQ(m.retired_count(), 0);
+  m.insert(100, 100);
+  EXPECT_EQ(m.retired_count(), 0);
+}
+
+TEST(RcuMapTest, BatchUpdateIsAtomic) {
+  RcuInts m;
+  auto reader = m.make_reader();
+  m.update([](RcuInts::version_type& v) {
+    for (int i = 0; i < 100; ++i) v.insert(i, i);
+  });
+  EXPECT_EQ(reader.pin()->size(), 100);
+  EXPECT_EQ(m.retired_count(), 0);
+}
+
+TEST(RcuMapTest, ReaderSlotsAreReused) {
+  RcuInts m;
+  for (int i = 0; i < 10; ++i) {
+    auto reader = m.make_reader();
+    auto guard = reader.pin();
+    m.insert(i, i);
+  }
+  m.reclaim();
+  EXPECT_EQ(m.retired_count(), 0);
+}
+
+TEST(RcuMapTest, ConcurrentReadersSeeConsistentVersions) {
+  RcuInts m;
+  std::atomic<bool> done{false};
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 3; ++t) {
+    readers.emplace_back([&m, &done] {
+      auto reader = m.make_reader();
+      while (!done.load()) {
+        auto guard = reader.pin();
+        // Writers always insert key i together with key -i.
+        for (const auto& kv : *guard) {
+          ASSERT_TRUE(guard->contains(-kv.first));
+        }
+      }
+    });
+  }
+  for (int i = 1; i <= 300; ++i) {
+    m.update([i](RcuInts::version_type& v) {
+      v.insert(i, i);
+      v.insert(-i, i);
+      if (i > 50) {
+        v.erase(i - 50);
+        v.erase(50 - i);
+      }
+    });
+  }
+  done.store(true);
+  for (auto& thread : readers) thread.join();
+  m.reclaim();
+  EXPECT_EQ(m.retired_count(), 0);
+  EXPECT_EQ(m.make_reader().pin()->size(), 100);
+}
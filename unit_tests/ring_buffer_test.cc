@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "../lace_queue.h"
+#include "../lace_ring_buffer.h"
+
+using RingInts = lace::ring_buffer<int>;
+
+namespace {
+
+// Copying throws once copies_left runs out; live counts the instances.
+struct counted {
+  static int live;
+  static int copies_left;
+
+  counted() { ++live; }
+  counted(const counted&) {
+    if (copies_left-- <= 0) throw std::runtime_error("copy failed");
+    ++live;
+  }
+  ~counted() { --live; }
+};
+
+int counted::live = 0;
+int counted::copies_left = 0;
+
+}  // namespace
+
+TEST(RingBufferTest, PushPopWrapsAround) {
+  RingInts ring;
+  EXPECT_TRUE(ring.empty());
+  EXPECT_EQ(ring.capacity(), 0);
+  for (int i = 0; i < 6; ++i) ring.push_back(i);
+  for (int i = 0; i < 4; ++i) ring.pop_front();
+  for (int i = 6; i < 12; ++i) ring.push_back(i);
+  EXPECT_EQ(ring.capacity(), RingInts::kMinCapacity);
+  EXPECT_EQ(ring.size(), 8);
+  for (int i = 0; i < 8; ++i) EXPECT_EQ(ring[i], i + 4);
+  EXPECT_EQ(ring.front(), 4);
+  EXPECT_EQ(ring.back(), 11);
+
+  ring.push_back(12);
+  EXPECT_EQ(ring.capacity(), 16);
+  for (int i = 0; i < 9; ++i) EXPECT_EQ(ring.at(i), i + 4);
+  EXPECT_THROW(ring.at(9), std::out_of_range);
+}
+
+TEST(RingBufferTest, EmptyAccessThrows) {
+  RingInts ring;
+  EXPECT_THROW(ring.front(), std::out_of_range);
+  EXPECT_THROW(ring.back(), std::out_of_range);
+  EXPECT_THROW(ring.pop_front(), std::out_of_range);
+}
+
+TEST(RingBufferTest, CopyMoveAndReserve) {
+  RingInts ring{1, 2, 3};
+  ring.pop_front();
+  RingInts copy(ring);
+  EXPECT_EQ(copy.size(), 2);
+  EXPECT_EQ(copy.front(), 2);
+  RingInts moved(std::move(copy));
+  EXPECT_EQ(moved.back(), 3);
+  EXPECT_TRUE(copy.empty());
+  copy = moved;
+  EXPECT_EQ(copy.size(), 2);
+
+  moved.reserve(100);
+  EXPECT_EQ(moved.capacity(), 128);
+  EXPECT_EQ(moved.front(), 2);
+  moved.clear();
+  EXPECT_TRUE(moved.empty());
+  EXPECT_EQ(moved.capacity(), 128);
+}
+
+TEST(RingBufferTest, ReservePastMaxSizeThrows) {
+  RingInts ring{1, 2, 3};
+  EXPECT_THROW(ring.reserve(ring.max_size() + 1), std::length_error);
+  EXPECT_THROW(ring.reserve(SIZE_MAX), std::length_error);
+  EXPECT_EQ(ring.size(), 3);
+  EXPECT_EQ(ring.capacity(), 8);
+  EXPECT_EQ(ring.front(), 1);
+}
+
+TEST(RingBufferTest, ThrowingCopyLeavesNothingBehind) {
+  {
+    lace::ring_buffer<counted> ring;
+    for (int i = 0; i < 5; ++i) ring.emplace_back();
+    counted::copies_left = 3;
+    EXPECT_THROW((lace::ring_buffer<counted>(ring)), std::runtime_error);
+    EXPECT_EQ(counted::live, 5);
+  }
+  EXPECT_EQ(counted::live, 0);
+}
+
+TEST(RingBufferTest, PushOwnElementWhileGrowing) {
+  lace::ring_buffer<std::string> ring;
+  for (int i = 0; i < 8; ++i) ring.push_back(std::string(40, 'a' + i));
+  ring.push_back(ring.front());
+  EXPECT_EQ(ring.size(), 9);
+  EXPECT_EQ(ring.back(), std::string(40, 'a'));
+  ring.emplace_back();
+  EXPECT_TRUE(ring.back().empty());
+}
+
+TEST(RingBufferTest, MoveOnlyElements) {
+  lace::ring_buffer<std::unique_ptr<int>> ring;
+  for (int i = 0; i < 20; ++i) ring.push_back(std::make_unique<int>(i));
+  for (int i = 0; i < 20; ++i) {
+    EXPECT_EQ(*ring.front(), i);
+    ring.pop_front();
+  }
+}
+
+TEST(RingBufferTest, IsQueueDefaultContainer) {
+  lace::queue<int> q;
+  for (int i = 0; i < 1000; ++i) {
+    q.push(i);
+    if (i % 3 == 0) q.pop();
+  }
+  EXPECT_EQ(q.size(), 666);
+  EXPECT_EQ(q.front(), 334);
+  EXPECT_EQ(q.back(), 999);
+}
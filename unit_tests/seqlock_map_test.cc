@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "../lace_seqlock_map.h"
+
+using SeqInts = lace::seqlock_map<int, int>;
+
+TEST(SeqlockMapTest, BasicOperations) {
+  SeqInts m{{2, 20}, {1, 10}};
+  EXPECT_EQ(m.size(), 2);
+  EXPECT_FALSE(m.insert(2, 21));
+  EXPECT_EQ(m.at(2), 20);
+  EXPECT_FALSE(m.insert_or_assign(2, 22));
+  EXPECT_TRUE(m.insert_or_assign(3, 30));
+  EXPECT_EQ(m.get(2), 22);
+  EXPECT_EQ(m.get(4), std::nullopt);
+  EXPECT_THROW(m.at(4), std::out_of_range);
+  EXPECT_TRUE(m.contains(3));
+
+  EXPECT_TRUE(m.erase(1));
+  EXPECT_FALSE(m.erase(1));
+  EXPECT_EQ(m.size(), 2);
+  m.clear();
+  EXPECT_TRUE(m.empty());
+  EXPECT_FALSE(m.contains(2));
+}
+
+TEST(SeqlockMapTest, StaysBalanced) {
+  SeqInts m;
+  for (int i = 0; i < 2000; ++i) m.insert(i, i);
+  EXPECT_TRUE(m.is_balanced());
+  for (int i = 0; i < 2000; i += 3) EXPECT_TRUE(m.erase(i));
+  EXPECT_TRUE(m.is_balanced());
+  for (int i = 0; i < 2000; ++i) EXPECT_EQ(m.contains(i), i % 3 != 0);
+
+  lace::map<int, int> copy = m.to_map();
+  EXPECT_EQ(copy.size(), m.size());
+  EXPECT_TRUE(copy.is_valid_rb_tree());
+  int previous = -1;
+  for (const auto& kv : copy) {
+    EXPECT_LT(previous, kv.first);
+    EXPECT_EQ(kv.first, kv.second);
+    previous = kv.first;
+  }
+}
+
+TEST(SeqlockMapTest, ForEachInRange) {
+  SeqInts m;
+  for (int i = 0; i < 100; ++i) m.insert(i * 2, i);
+  std::vector<int> keys;
+  m.for_each_in_range(10, 20,
+                      [&](const auto& kv) { keys.push_back(kv.first); });
+  EXPECT_EQ(keys, std::vector<int>({10, 12, 14, 16, 18}));
+
+  int visited = 0;
+  m.for_each_in_range(0, 200, [&](const auto&) { return ++visited < 3; });
+  EXPECT_EQ(visited, 3);
+}
+
+TEST(SeqlockMapTest, ReadersDuringWrites) {
+  SeqInts m;
+  const int keys = 512;
+  std::atomic<bool> done{false};
+  std::vector<std::thread> readers;
+  for (int r = 0; r < 3; ++r) {
+    readers.emplace_back([&] {
+      while (!done) {
+        for (int k = 0; k < keys; k += 7) {
+          auto value = m.get(k);
+          if (value) {
+            EXPECT_EQ(*value, k * 3);
+          }
+        }
+        int previous = -1;
+        m.for_each_in_range(0, keys, [&](const auto& kv) {
+          EXPECT_LT(previous, kv.first);
+          EXPECT_EQ(kv.second, kv.first * 3);
+          previous = kv.first;
+        });
+      }
+    });
+  }
+  for (int round = 0; round < 20; ++round) {
+    for (int k = 0; k < keys; ++k) m.insert_or_assign(k, k * 3);
+    for (int k = round % 2; k < keys; k += 2) m.erase(k);
+  }
+  done = true;
+  for (auto& r : readers) r.join();
+  EXPECT_TRUE(m.is_balanced());
+  EXPECT_EQ(m.size(), keys / 2);
+}
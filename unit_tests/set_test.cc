@@ -1,10 +1,13 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <iterator>
 #include <random>
 #include <set>
 #include <utility>
 
 #include "../lace_set.h"
+#include "../lace_parallel.h"
 
 // заменить на lace::set
 using SetInts = lace::set<int>;
@@ -615,4 +618,93 @@ TEST(SetOperatorTest, MoveOperatorTest) {
   ASSERT_EQ(*b.begin(), 1);
   ASSERT_EQ(b.size(), 2);
   ASSERT_TRUE(a.empty());
-}
\ No newline at end of file
+}
+
+TEST(SetTest, ForEachInRange) {
+  lace::set<int> s = {5, 1, 9, 3, 7, 11};
+  std::vector<int> visited;
+  s.for_each_in_range(3, 9, [&visited](int key) { visited.push_back(key); });
+  EXPECT_EQ(visited, std::vector<int>({3, 5, 7}));
+
+  visited.clear();
+  s.for_each_in_range(0, 100, [&visited](int key) {
+    visited.push_back(key);
+    return visited.size() < 2;
+  });
+  EXPECT_EQ(visited, std::vector<int>({1, 3}));
+}
+
+TEST(SetTest, BuildParallel) {
+  std::vector<int> keys;
+  for (int i = 0; i < 50000; ++i) keys.push_back((i * 7919) % 20000);
+  auto s = lace::build_parallel<lace::set<int>>(keys.begin(), keys.end(), 4);
+  EXPECT_EQ(s.size(), 20000);
+  int expected = 0;
+  for (int key : s) EXPECT_EQ(key, expected++);
+}
+
+TEST(SetTest, SetAlgebraMatchesStd) {
+  std::mt19937 gen(7);
+  std::uniform_int_distribution<int> dist(0, 3000);
+  SetInts a;
+  SetInts b;
+  OriginalSetInts std_a;
+  OriginalSetInts std_b;
+  for (int i = 0; i < 1500; ++i) {
+    int x = dist(gen);
+    int y = dist(gen);
+    a.insert(x);
+    std_a.insert(x);
+    b.insert(y);
+    std_b.insert(y);
+  }
+
+  auto check = [](const SetInts& result, const std::vector<int>& expected) {
+    std::vector<int> keys;
+    for (int key : result) keys.push_back(key);
+    EXPECT_EQ(keys, expected);
+  };
+  std::vector<int> expected;
+  std::set_union(std_a.begin(), std_a.end(), std_b.begin(), std_b.end(),
+                 std::back_inserter(expected));
+  check(lace::set_union(a, b), expected);
+  expected.clear();
+  std::set_intersection(std_a.begin(), std_a.end(), std_b.begin(),
+                        std_b.end(), std::back_inserter(expected));
+  check(lace::set_intersection(a, b), expected);
+  expected.clear();
+  std::set_difference(std_a.begin(), std_a.end(), std_b.begin(), std_b.end(),
+                      std::back_inserter(expected));
+  check(lace::set_difference(a, b), expected);
+  expected.clear();
+  std::set_symmetric_difference(std_a.begin(), std_a.end(), std_b.begin(),
+                                std_b.end(), std::back_inserter(expected));
+  check(lace::symmetric_difference(a, b), expected);
+
+  EXPECT_TRUE(lace::set_intersection(a, SetInts()).empty());
+  EXPECT_EQ(lace::set_union(SetInts(), b).size(), b.size());
+}
+
+TEST(SetTest, ParallelSetAlgebraMatchesSequential) {
+  std::vector<int> evens;
+  std::vector<int> thirds;
+  for (int i = 0; i < 200000; i += 2) evens.push_back(i);
+  for (int i = 0; i < 60000; i += 3) thirds.push_back(i);
+  auto a = SetInts::from_sorted(evens);
+  auto b = SetInts::from_sorted(thirds);
+
+  using parallel_op = SetInts (*)(const SetInts&, const SetInts&, unsigned);
+  const parallel_op ops[] = {
+      &lace::set_union<int>, &lace::set_intersection<int>,
+      &lace::set_difference<int>, &lace::symmetric_difference<int>};
+  for (parallel_op op : ops) {
+    auto sequential = op(a, b, 1);
+    auto parallel = op(a, b, 4);
+    auto swapped = op(b, a, 4);
+    ASSERT_EQ(parallel.size(), sequential.size());
+    auto it = sequential.begin();
+    for (int key : parallel) EXPECT_EQ(key, *it++);
+    EXPECT_EQ(swapped.size(), op(b, a, 1).size());
+  }
+  EXPECT_EQ(lace::set_intersection(a, b, 4).size(), 10000);
+}
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../lace_sharded_map.h"
+
+using ShardedInts = lace::sharded_map<int, int, 8>;
+
+TEST(ShardedMapTest, BasicOperations) {
+  ShardedInts m;
+  EXPECT_TRUE(m.empty());
+  EXPECT_TRUE(m.insert(1, 10));
+  EXPECT_FALSE(m.insert(1, 11));
+  EXPECT_EQ(m.get(1), 10);
+  EXPECT_FALSE(m.insert_or_assign(1, 12));
+  EXPECT_EQ(m.get(1), 12);
+  EXPECT_TRUE(m.insert_or_assign(2, 20));
+  EXPECT_EQ(m.size(), 2);
+  EXPECT_TRUE(m.contains(2));
+  EXPECT_FALSE(m.get(3).has_value());
+
+  EXPECT_TRUE(m.update(2, [](int& v) { v += 1; }));
+  EXPECT_FALSE(m.update(3, [](int& v) { v += 1; }));
+  int seen = 0;
+  EXPECT_TRUE(m.visit(2, [&seen](const int& v) { seen = v; }));
+  EXPECT_EQ(seen, 21);
+
+  EXPECT_TRUE(m.erase(1));
+  EXPECT_FALSE(m.erase(1));
+  EXPECT_EQ(m.size(), 1);
+  m.clear();
+  EXPECT_TRUE(m.empty());
+}
+
+TEST(ShardedMapTest, KeysSpreadAcrossShards) {
+  ShardedInts m;
+  for (int i = 0; i < 1000; ++i) m.insert(i, i);
+  for (size_t i = 0; i < ShardedInts::shard_count(); ++i) {
+    size_t shard_size = 0;
+    m.with_shard(i, [&shard_size](const lace::map<int, int>& shard) {
+      shard_size = shard.size();
+    });
+    EXPECT_GT(shard_size, 50);
+    EXPECT_LT(shard_size, 200);
+  }
+}
+
+TEST(ShardedMapTest, OrderedViewMergesShards) {
+  lace::sharded_map<std::string, int, 4> m;
+  std::vector<std::string> words = {"pear", "apple", "fig", "kiwi", "banana",
+                                    "cherry", "date", "grape", "lemon"};
+  for (size_t i = 0; i < words.size(); ++i) m.insert(words[i], i);
+
+  std::vector<std::string> ordered;
+  {
+    auto view = m.ordered();
+    for (const auto& kv : view) ordered.push_back(kv.first);
+  }
+  std::vector<std::string> expected = words;
+  std::sort(expected.begin(), expected.end());
+  EXPECT_EQ(ordered, expected);
+
+  lace::sharded_map<int, int, 4> empty;
+  auto view = empty.ordered();
+  EXPECT_EQ(view.begin(), view.end());
+}
+
+TEST(ShardedMapTest, OrderedViewLooksUpUnderItsOwnLocks) {
+  lace::sharded_map<int, int, 4> m;
+  for (int i = 0; i < 100; ++i) m.insert(i, i * 2);
+  std::thread writer;
+  {
+    auto view = m.ordered();
+    // Queued behind the view's shared locks.
+    writer = std::thread([&m] { m.insert(1000, 1); });
+    EXPECT_EQ(view.size(), 100);
+    EXPECT_FALSE(view.empty());
+    EXPECT_TRUE(view.contains(42));
+    EXPECT_FALSE(view.contains(1000));
+    EXPECT_EQ(view.get(21), 42);
+    EXPECT_EQ(view.get(-1), std::nullopt);
+  }
+  writer.join();
+  EXPECT_EQ(m.get(1000), 1);
+  EXPECT_EQ(m.ordered().size(), 101);
+}
+
+TEST(ShardedMapTest, BatchOperations) {
+  ShardedInts m;
+  std::vector<std::pair<int, int>> items;
+  for (int i = 0; i < 500; ++i) items.emplace_back(i % 300, i);
+  EXPECT_EQ(m.insert_batch(items.begin(), items.end()), 300);
+  EXPECT_EQ(m.size(), 300);
+  EXPECT_EQ(m.get(10), 10);
+
+  std::vector<int> keys = {1, 2, 3, 1000};
+  EXPECT_EQ(m.erase_batch(keys.begin(), keys.end()), 3);
+  EXPECT_EQ(m.size(), 297);
+}
+
+TEST(ShardedMapTest, ConcurrentWritersAndReaders) {
+  ShardedInts m;
+  constexpr int kThreads = 4;
+  constexpr int kPerThread = 2000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&m, t] {
+      for (int i = 0; i < kPerThread; ++i) {
+        int key = t * kPerThread + i;
+        m.insert(key, key);
+        EXPECT_EQ(m.get(key), key);
+        if (i % 2 == 0) m.erase(key);
+      }
+    });
+  }
+  threads.emplace_back([&m] {
+    for (int i = 0; i < 20; ++i) {
+      auto view = m.ordered();
+      int previous = -1;
+      for (const auto& kv : view) {
+        EXPECT_LT(previous, kv.first);
+        previous = kv.first;
+      }
+    }
+  });
+  for (auto& thread : threads) thread.join();
+
+  EXPECT_EQ(m.size(), kThreads * kPerThread / 2);
+  int expected = 1;
+  for (const auto& kv : m.ordered()) {
+    EXPECT_EQ(kv.first, expected);
+    expected += 2;
+  }
+}
@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "../lace_shm_queue.h"
+
+namespace {
+
+struct message {
+  int producer;
+  int sequence;
+  double payload;
+};
+
+std::string segment_name(const char* tag) {
+  return "/lace_test_" + std::string(tag) + "_" + std::to_string(::getpid());
+}
+
+// Forks a child that runs fn and exits without returning into gtest.
+template <typename Fn>
+pid_t spawn(Fn fn) {
+  pid_t pid = ::fork();
+  if (pid == 0) {
+    fn();
+    ::_exit(0);
+  }
+  return pid;
+}
+
+bool exited_cleanly(pid_t pid) {
+  int status = 0;
+  return ::waitpid(pid, &status, 0) == pid && WIFEXITED(status) &&
+         WEXITSTATUS(status) == 0;
+}
+
+}  // namespace
+
+TEST(ShmQueueTest, FifoWithinCapacity) {
+  std::string name = segment_name("fifo");
+  auto q = lace::shm_queue<int>::create(name, 3);
+  EXPECT_EQ(q.capacity(), 4);
+  // A second mapping of the same segment, at a different address.
+  auto view = lace::shm_queue<int>::open(name);
+  EXPECT_TRUE(lace::shm_queue<int>::unlink(name));
+  int out = 0;
+  EXPECT_FALSE(view.try_pop(out));
+  for (int i = 0; i < 4; ++i) EXPECT_TRUE(q.try_push(i));
+  EXPECT_FALSE(q.try_push(4));
+  EXPECT_EQ(view.size(), 4);
+  for (int lap = 0; lap < 10; ++lap) {
+    EXPECT_TRUE(view.try_pop(out));
+    EXPECT_EQ(out, lap);
+    q.push(lap + 4);
+  }
+}
+
+TEST(ShmQueueTest, OpenChecksTheSegment) {
+  std::string name = segment_name("check");
+  EXPECT_THROW(lace::shm_queue<int>::open(name), std::system_error);
+  auto q = lace::shm_queue<int>::create(name, 8);
+  EXPECT_THROW(lace::shm_queue<int>::create(name, 8), std::system_error);
+  EXPECT_THROW(lace::shm_queue<long>::open(name), std::runtime_error);
+  EXPECT_THROW(lace::shm_mpsc_queue<int>::open(name), std::runtime_error);
+  lace::shm_queue<int>::unlink(name);
+}
+
+TEST(ShmQueueTest, RejectsCapacitiesWithoutAPowerOfTwo) {
+  std::string name = segment_name("huge");
+  size_t huge = (size_t(1) << 63) + 1;
+  EXPECT_THROW(lace::shm_queue<message>::create(name, huge),
+               std::length_error);
+  EXPECT_THROW(lace::shm_mpsc_queue<message>::create(name, size_t(-1)),
+               std::length_error);
+  // Nothing was created under the name.
+  EXPECT_FALSE(lace::shm_queue<message>::unlink(name));
+}
+
+TEST(ShmQueueTest, SingleProducerProcess) {
+  std::string name = segment_name("spsc");
+  auto q = lace::shm_queue<message>::create(name, 64);
+  const int count = 100000;
+  // Mapped before the fork so the child cannot fail to find the segment.
+  auto producer = lace::shm_queue<message>::open(name);
+  pid_t child = spawn([&producer] {
+    for (int i = 0; i < count; ++i) producer.push({0, i, i * 0.5});
+  });
+  lace::shm_queue<message>::unlink(name);
+  message m;
+  for (int i = 0; i < count; ++i) {
+    q.pop(m);
+    ASSERT_EQ(m.sequence, i);
+    ASSERT_EQ(m.payload, i * 0.5);
+  }
+  EXPECT_TRUE(exited_cleanly(child));
+  EXPECT_TRUE(q.empty());
+}
+
+TEST(ShmQueueTest, ManyProducerProcesses) {
+  std::string name = segment_name("mpsc");
+  auto q = lace::shm_mpsc_queue<message>::create(name, 32);
+  const int producers = 3;
+  const int count = 30000;
+  std::vector<pid_t> children;
+  for (int p = 0; p < producers; ++p) {
+    auto producer = lace::shm_mpsc_queue<message>::open(name);
+    children.push_back(spawn([&producer, p] {
+      for (int i = 0; i < count; ++i) producer.push({p, i, 0});
+    }));
+  }
+  lace::shm_mpsc_queue<message>::unlink(name);
+  std::vector<int> next(producers, 0);
+  message m;
+  for (int i = 0; i < producers * count; ++i) {
+    q.pop(m);
+    ASSERT_EQ(m.sequence, next[m.producer]++);
+  }
+  for (pid_t child : children) EXPECT_TRUE(exited_cleanly(child));
+  for (int p = 0; p < producers; ++p) EXPECT_EQ(next[p], count);
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../lace_spsc_queue.h"
+
+TEST(SpscQueueTest, CapacityAndFullEmpty) {
+  lace::spsc_queue<int> q(5);
+  EXPECT_EQ(q.capacity(), 8);
+  EXPECT_TRUE(q.empty());
+  int out = 0;
+  EXPECT_FALSE(q.try_pop(out));
+  for (int i = 0; i < 8; ++i) EXPECT_TRUE(q.try_push(i));
+  EXPECT_FALSE(q.try_push(8));
+  EXPECT_EQ(q.size(), 8);
+  for (int round = 0; round < 20; ++round) {
+    EXPECT_TRUE(q.try_pop(out));
+    EXPECT_EQ(out, round);
+    EXPECT_TRUE(q.try_push(round + 8));
+  }
+}
+
+TEST(SpscQueueTest, RejectsCapacityPastMax) {
+  using queue = lace::spsc_queue<int>;
+  EXPECT_THROW(queue(queue::max_capacity() + 1), std::length_error);
+  EXPECT_THROW(queue(SIZE_MAX), std::length_error);
+}
+
+TEST(SpscQueueTest, BatchPushPop) {
+  lace::spsc_queue<int> q(16);
+  std::vector<int> in(20);
+  for (int i = 0; i < 20; ++i) in[i] = i;
+  EXPECT_EQ(q.push_n(in.begin(), in.size()), 16);
+  std::vector<int> out;
+  EXPECT_EQ(q.pop_n(std::back_inserter(out), 10), 10);
+  EXPECT_EQ(q.push_n(in.begin() + 16, 4), 4);
+  EXPECT_EQ(q.pop_n(std::back_inserter(out), 100), 10);
+  EXPECT_EQ(out, in);
+  EXPECT_EQ(q.pop_n(std::back_inserter(out), 1), 0);
+}
+
+TEST(SpscQueueTest, DestroysLeftoverElements) {
+  auto tracked = std::make_shared<int>(0);
+  {
+    lace::spsc_queue<std::shared_ptr<int>> q(4);
+    q.try_push(tracked);
+    q.try_emplace(tracked);
+    std::shared_ptr<int> out;
+    EXPECT_TRUE(q.try_pop(out));
+    EXPECT_EQ(tracked.use_count(), 3);
+  }
+  EXPECT_EQ(tracked.use_count(), 1);
+}
+
+TEST(SpscQueueTest, ProducerConsumerKeepOrder) {
+  lace::spsc_queue<std::string> q(64);
+  const int count = 100000;
+  std::thread producer([&q] {
+    std::vector<std::string> batch;
+    for (int i = 0; i < count;) {
+      if (i % 3 == 0) {
+        batch.clear();
+        for (int j = i; j < i + 5 && j < count; ++j) {
+          batch.push_back(std::to_string(j));
+        }
+        i += static_cast<int>(q.push_n(batch.begin(), batch.size()));
+      } else if (q.try_push(std::to_string(i))) {
+        ++i;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+  int expected = 0;
+  std::vector<std::string> batch;
+  while (expected < count) {
+    std::string value;
+    if (expected % 2 == 0 && q.try_pop(value)) {
+      EXPECT_EQ(value, std::to_string(expected++));
+    } else {
+      batch.clear();
+      if (q.pop_n(std::back_inserter(batch), 7) == 0) {
+        std::this_thread::yield();
+      }
+      for (const auto& item : batch) {
+        EXPECT_EQ(item, std::to_string(expected++));
+      }
+    }
+  }
+  producer.join();
+  EXPECT_TRUE(q.empty());
+}
@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+#include <vector>
+
+#include "../lace_map.h"
+#include "../lace_parallel.h"
+
+using namespace lace;
+
+TEST(RBTreeBuildTests, from_sorted_is_valid_for_every_size) {
+  for (int size = 0; size < 300; ++size) {
+    std::vector<std::pair<int, int>> items;
+    for (int i = 0; i < size; ++i) items.emplace_back(i, -i);
+    auto tree = map<int, int>::from_sorted(items.begin(), items.end());
+    ASSERT_EQ(tree.size(), static_cast<size_t>(size));
+    ASSERT_TRUE(tree.is_valid_rb_tree()) << size;
+    int expected = 0;
+    for (const auto& kv : tree) {
+      EXPECT_EQ(kv.first, expected);
+      EXPECT_EQ(kv.second, -expected);
+      ++expected;
+    }
+    EXPECT_EQ(expected, size);
+  }
+}
+
+TEST(RBTreeBuildTests, built_tree_supports_updates) {
+  std::vector<std::pair<int, int>> items;
+  for (int i = 0; i < 100; ++i) items.emplace_back(i * 2, i);
+  auto tree = map<int, int>::from_sorted(items.begin(), items.end());
+  tree.insert(-1, 0);
+  tree.insert(1000, 0);
+  for (int i = 0; i < 100; i += 3) tree.erase(i * 2);
+  EXPECT_TRUE(tree.is_valid_rb_tree());
+  EXPECT_EQ(tree.begin()->first, -1);
+  EXPECT_EQ((--tree.end())->first, 1000);
+  EXPECT_EQ(tree.size(), 102 - 34);
+}
+
+TEST(RBTreeBuildTests, build_parallel_first_duplicate_wins) {
+  std::vector<std::pair<int, std::string>> items = {
+      {3, "a"}, {1, "b"}, {3, "c"}, {2, "d"}, {1, "e"}};
+  auto tree = build_parallel<map<int, std::string>>(items.begin(), items.end());
+  EXPECT_EQ(tree.size(), 3);
+  EXPECT_EQ(tree.at(1), "b");
+  EXPECT_EQ(tree.at(2), "d");
+  EXPECT_EQ(tree.at(3), "a");
+  EXPECT_TRUE(tree.is_valid_rb_tree());
+}
+
+TEST(RBTreeBuildTests, build_parallel_matches_insert_loop) {
+  std::mt19937 gen(30);
+  std::uniform_int_distribution<int> dist(0, 60000);
+  std::vector<std::pair<int, int>> items;
+  for (int i = 0; i < 100000; ++i) items.emplace_back(dist(gen), i);
+
+  std::map<int, int> reference;
+  for (const auto& item : items) reference.insert(item);
+
+  for (unsigned threads : {1u, 3u, 8u}) {
+    auto tree =
+        build_parallel<map<int, int>>(items.begin(), items.end(), threads);
+    ASSERT_EQ(tree.size(), reference.size());
+    ASSERT_TRUE(tree.is_valid_rb_tree());
+    auto it = tree.begin();
+    for (const auto& kv : reference) {
+      ASSERT_EQ(it->first, kv.first);
+      ASSERT_EQ(it->second, kv.second);
+      ++it;
+    }
+  }
+}
+
+TEST(RBTreeBuildTests, build_parallel_empty) {
+  std::vector<std::pair<int, int>> items;
+  auto tree = build_parallel<map<int, int>>(items.begin(), items.end(), 4);
+  EXPECT_TRUE(tree.empty());
+  EXPECT_EQ(tree.begin(), tree.end());
+}
@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+#include <vector>
+
+#include "../lace_map.h"
+#include "../lace_set.h"
+
+using namespace lace;
+
+TEST(RBTreeFingerTests, lower_bound_from_forward) {
+  map<int, int> tree;
+  for (int i = 0; i < 200; i += 2) tree.insert(i, i * 10);
+
+  auto it = tree.begin();
+  for (int key = 0; key < 199; ++key) {
+    it = tree.lower_bound_from(it, key);
+    ASSERT_NE(it, tree.end());
+    EXPECT_EQ(it->first, key % 2 == 0 ? key : key + 1);
+  }
+  EXPECT_EQ(tree.lower_bound_from(it, 199), tree.end());
+  EXPECT_EQ(tree.lower_bound_from(it, 1000), tree.end());
+}
+
+TEST(RBTreeFingerTests, lower_bound_from_backward) {
+  map<int, int> tree;
+  for (int i = 0; i < 100; ++i) tree.insert(i * 3, i);
+
+  auto it = tree.find(297);
+  for (int key = 297; key >= -5; --key) {
+    auto expected = tree.lower_bound(key);
+    it = tree.lower_bound_from(it, key);
+    ASSERT_EQ(it, expected);
+  }
+  EXPECT_EQ(it, tree.begin());
+}
+
+TEST(RBTreeFingerTests, lower_bound_from_end_and_empty) {
+  map<int, int> empty;
+  EXPECT_EQ(empty.lower_bound_from(empty.end(), 1), empty.end());
+
+  map<int, int> tree = {{1, 1}, {5, 5}, {9, 9}};
+  EXPECT_EQ(tree.lower_bound_from(tree.end(), 4)->first, 5);
+  EXPECT_EQ(tree.lower_bound_from(tree.end(), 10), tree.end());
+}
+
+TEST(RBTreeFingerTests, lower_bound_from_matches_lower_bound) {
+  map<int, int> tree;
+  std::mt19937 gen(26);
+  std::uniform_int_distribution<int> dist(-500, 500);
+  for (int i = 0; i < 300; ++i) tree.insert(dist(gen), i);
+
+  std::vector<map<int, int>::iterator> fingers = {tree.end()};
+  for (auto it = tree.begin(); it != tree.end(); ++it) fingers.push_back(it);
+  for (auto finger : fingers) {
+    for (int key = -510; key <= 510; key += 7) {
+      EXPECT_EQ(tree.lower_bound_from(finger, key), tree.lower_bound(key));
+    }
+  }
+}
+
+TEST(RBTreeFingerTests, const_lower_bound_from) {
+  map<int, std::string> tree = {{1, "one"}, {3, "three"}, {5, "five"}};
+  const auto& ctree = tree;
+  auto it = ctree.begin();
+  it = ctree.lower_bound_from(it, 2);
+  EXPECT_EQ(it->first, 3);
+  it = ctree.lower_bound_from(it, 5);
+  EXPECT_EQ(it->second, "five");
+  EXPECT_EQ(ctree.lower_bound_from(it, 6), ctree.end());
+}
+
+TEST(RBTreeFingerTests, find_from) {
+  map<int, std::string> tree = {{1, "one"}, {3, "three"}, {5, "five"}};
+  auto it = tree.find_from(tree.begin(), 3);
+  ASSERT_NE(it, tree.end());
+  EXPECT_EQ(it->second, "three");
+  EXPECT_EQ(tree.find_from(it, 4), tree.end());
+  EXPECT_EQ(tree.find_from(it, 1)->second, "one");
+
+  const auto& ctree = tree;
+  EXPECT_EQ(ctree.find_from(ctree.begin(), 5)->second, "five");
+  EXPECT_EQ(ctree.find_from(ctree.begin(), 0), ctree.end());
+}
+
+TEST(RBTreeFingerTests, insert_with_hint_ascending) {
+  map<int, int> tree;
+  auto hint = tree.end();
+  for (int i = 0; i < 1000; ++i) {
+    hint = tree.insert(hint, {i, -i});
+    EXPECT_EQ(hint->first, i);
+  }
+  EXPECT_EQ(tree.size(), 1000);
+  EXPECT_TRUE(tree.is_valid_rb_tree());
+  int expected = 0;
+  for (const auto& kv : tree) EXPECT_EQ(kv.first, expected++);
+  EXPECT_EQ((--tree.end())->first, 999);
+}
+
+TEST(RBTreeFingerTests, insert_with_hint_random) {
+  map<int, int> tree;
+  std::map<int, int> reference;
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> dist(0, 2000);
+  auto hint = tree.begin();
+  for (int i = 0; i < 1000; ++i) {
+    int key = dist(gen);
+    hint = tree.insert(hint, {key, i});
+    reference.insert({key, i});
+    EXPECT_EQ(hint->first, key);
+    EXPECT_EQ(hint->second, reference[key]);
+  }
+  EXPECT_TRUE(tree.is_valid_rb_tree());
+  ASSERT_EQ(tree.size(), reference.size());
+  auto ref_it = reference.begin();
+  for (const auto& kv : tree) {
+    EXPECT_EQ(kv.first, ref_it->first);
+    EXPECT_EQ(kv.second, ref_it->second);
+    ++ref_it;
+  }
+  EXPECT_EQ(tree.begin()->first, reference.begin()->first);
+}
+
+TEST(RBTreeFingerTests, set_finger_search) {
+  set<int> left = {1, 4, 6, 9, 12, 15};
+  set<int> right = {2, 4, 9, 10, 15, 20};
+  std::vector<int> common;
+  auto finger = right.begin();
+  for (int key : left) {
+    finger = right.lower_bound_from(finger, key);
+    if (finger == right.end()) break;
+    if (*finger == key) common.push_back(key);
+  }
+  EXPECT_EQ(common, std::vector<int>({4, 9, 15}));
+  EXPECT_NE(right.find_from(right.begin(), 10), right.end());
+  EXPECT_EQ(right.find_from(right.begin(), 11), right.end());
+
+  auto hint = left.insert(left.end(), 13);
+  EXPECT_EQ(*hint, 13);
+  EXPECT_EQ(left.size(), 7);
+  EXPECT_EQ(*left.insert(hint, 13), 13);
+  EXPECT_EQ(left.size(), 7);
+}
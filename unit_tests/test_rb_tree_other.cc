@@ -3,6 +3,7 @@
 #include <climits>
 
 #include "../lace_map.h"
+#include "throw_on_number_created.h"
 
 namespace lace {
 
@@ -570,4 +571,33 @@ TEST(MapIteratorTest, ConstNextNodeFullCoverage) {
   EXPECT_EQ(it->first, 30);
 }
 
+TEST(RBTreeOtherTests, CopyKeepsShapeAndOrder) {
+  map<int, int> tree1;
+  for (int i = 0; i < 500; ++i) tree1.insert((i * 37) % 500, i);
+  map<int, int> tree2(tree1);
+  ASSERT_EQ(tree2.size(), tree1.size());
+  EXPECT_TRUE(tree2.is_valid_rb_tree());
+  auto it = tree1.begin();
+  for (const auto& kv : tree2) {
+    EXPECT_EQ(kv.first, it->first);
+    EXPECT_EQ(kv.second, it->second);
+    ++it;
+  }
+  EXPECT_EQ(tree2.begin()->first, 0);
+  EXPECT_EQ((--tree2.end())->first, 499);
+  tree2.insert(1000, 0);
+  EXPECT_FALSE(tree1.contains(1000));
+}
+
+TEST(RBTreeOtherTests, CopyThrowingValueDoesNotLeak) {
+  ThrowOnNumberCreated::Reset(0);
+  map<int, ThrowOnNumberCreated> tree1;
+  for (int i = 0; i < 20; ++i) tree1.insert(i, ThrowOnNumberCreated());
+  ThrowOnNumberCreated::Reset(15);
+  using ThrowingMap = map<int, ThrowOnNumberCreated>;
+  EXPECT_THROW(ThrowingMap tree2(tree1), std::runtime_error);
+  ThrowOnNumberCreated::Reset(0);
+  EXPECT_EQ(tree1.size(), 20);
+}
+
 }  // namespace lace
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "../lace_map.h"
+
+using namespace lace;
+
+TEST(RBTreeRangeTests, visits_half_open_range_in_order) {
+  map<int, int> tree;
+  for (int i = 0; i < 100; ++i) tree.insert(i, i * i);
+
+  std::vector<int> keys;
+  tree.for_each_in_range(10, 20, [&keys](const std::pair<const int, int>& kv) {
+    keys.push_back(kv.first);
+  });
+  ASSERT_EQ(keys.size(), 10);
+  for (int i = 0; i < 10; ++i) EXPECT_EQ(keys[i], 10 + i);
+}
+
+TEST(RBTreeRangeTests, bounds_between_keys) {
+  map<int, int> tree = {{2, 0}, {4, 0}, {6, 0}, {8, 0}};
+  std::vector<int> keys;
+  tree.for_each_in_range(3, 7, [&keys](const auto& kv) {
+    keys.push_back(kv.first);
+  });
+  EXPECT_EQ(keys, std::vector<int>({4, 6}));
+}
+
+TEST(RBTreeRangeTests, empty_ranges) {
+  map<int, int> empty;
+  int calls = 0;
+  empty.for_each_in_range(0, 10, [&calls](const auto&) { ++calls; });
+  EXPECT_EQ(calls, 0);
+
+  map<int, int> tree = {{1, 1}, {2, 2}, {3, 3}};
+  tree.for_each_in_range(2, 2, [&calls](const auto&) { ++calls; });
+  tree.for_each_in_range(5, 9, [&calls](const auto&) { ++calls; });
+  tree.for_each_in_range(3, 1, [&calls](const auto&) { ++calls; });
+  EXPECT_EQ(calls, 0);
+}
+
+TEST(RBTreeRangeTests, early_termination) {
+  map<int, int> tree;
+  for (int i = 0; i < 50; ++i) tree.insert(i, i);
+  std::vector<int> keys;
+  tree.for_each_in_range(0, 50, [&keys](const auto& kv) {
+    keys.push_back(kv.first);
+    return kv.first < 4;
+  });
+  EXPECT_EQ(keys, std::vector<int>({0, 1, 2, 3, 4}));
+}
+
+TEST(RBTreeRangeTests, mutates_values) {
+  map<int, int> tree = {{1, 1}, {2, 2}, {3, 3}, {4, 4}};
+  tree.for_each_in_range(2, 4, [](auto& kv) { kv.second *= 10; });
+  EXPECT_EQ(tree.at(1), 1);
+  EXPECT_EQ(tree.at(2), 20);
+  EXPECT_EQ(tree.at(3), 30);
+  EXPECT_EQ(tree.at(4), 4);
+}
+
+TEST(RBTreeRangeTests, matches_iterator_walk) {
+  map<int, int> tree;
+  std::mt19937 gen(27);
+  std::uniform_int_distribution<int> dist(-1000, 1000);
+  for (int i = 0; i < 2000; ++i) tree.insert(dist(gen), i);
+  for (int i = 0; i < 200; ++i) tree.erase(dist(gen));
+
+  const auto& ctree = tree;
+  for (int lo = -1010; lo < 1010; lo += 97) {
+    int hi = lo + 250;
+    std::vector<int> expected;
+    for (auto it = ctree.lower_bound(lo); it != ctree.end() && it->first < hi;
+         ++it) {
+      expected.push_back(it->first);
+    }
+    std::vector<int> visited;
+    ctree.for_each_in_range(lo, hi, [&visited](const auto& kv) {
+      visited.push_back(kv.first);
+    });
+    EXPECT_EQ(visited, expected);
+  }
+}
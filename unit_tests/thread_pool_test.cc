@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "../lace_thread_pool.h"
+
+namespace {
+
+// Allocations the calling thread may still make before operator new throws;
+// negative means never.
+thread_local int allocations_left = -1;
+
+}  // namespace
+
+void* operator new(size_t size) {
+  if (allocations_left >= 0 && allocations_left-- == 0) throw std::bad_alloc();
+  if (void* p = std::malloc(size == 0 ? 1 : size)) return p;
+  throw std::bad_alloc();
+}
+
+// Every form is replaced so that all memory comes from malloc and goes back
+// to free.
+void* operator new[](size_t size) { return operator new(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  try {
+    return operator new(size);
+  } catch (const std::bad_alloc&) {
+    return nullptr;
+  }
+}
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept {
+  return operator new(size, tag);
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+  std::free(p);
+}
+
+namespace {
+
+long fib(lace::thread_pool& pool, int n) {
+  if (n < 2) return n;
+  if (n < 12) return fib(pool, n - 1) + fib(pool, n - 2);
+  long left = 0;
+  lace::task_group group(pool);
+  group.run([&] { left = fib(pool, n - 1); });
+  long right = fib(pool, n - 2);
+  group.wait();
+  return left + right;
+}
+
+}  // namespace
+
+TEST(ThreadPoolTest, SubmittedTasksRunBeforeDestruction) {
+  std::atomic<int> ran{0};
+  {
+    lace::thread_pool pool(3);
+    EXPECT_EQ(pool.size(), 3);
+    for (int i = 0; i < 1000; ++i) {
+      pool.submit([&ran, &pool, i] {
+        ran++;
+        if (i % 10 == 0) pool.submit([&ran] { ran++; });
+      });
+    }
+  }
+  EXPECT_EQ(ran.load(), 1100);
+}
+
+TEST(ThreadPoolTest, NestedForkJoin) {
+  lace::thread_pool pool(4);
+  EXPECT_EQ(fib(pool, 25), 75025);
+  // One worker forces every wait to help instead of block.
+  lace::thread_pool single(1);
+  EXPECT_EQ(fib(single, 20), 6765);
+}
+
+TEST(ThreadPoolTest, TaskGroupRethrowsFirstError) {
+  lace::thread_pool pool(2);
+  lace::task_group group(pool);
+  std::atomic<int> ran{0};
+  for (int i = 0; i < 100; ++i) {
+    group.run([&ran, i] {
+      ran++;
+      if (i == 50) throw std::runtime_error("task failed");
+    });
+  }
+  EXPECT_THROW(group.wait(), std::runtime_error);
+  EXPECT_EQ(ran.load(), 100);
+  group.run([&ran] { ran++; });
+  group.wait();
+  EXPECT_EQ(ran.load(), 101);
+}
+
+TEST(ThreadPoolTest, SharedPoolFromManyThreads) {
+  std::vector<std::thread> callers;
+  std::vector<long> results(4);
+  for (int t = 0; t < 4; ++t) {
+    callers.emplace_back([&results, t] {
+      results[t] = fib(lace::thread_pool::shared(), 18 + t);
+    });
+  }
+  for (auto& caller : callers) caller.join();
+  EXPECT_EQ(results[0], 2584);
+  EXPECT_EQ(results[3], 10946);
+}
+
+TEST(ThreadPoolTest, SubmitThatCannotQueueLeavesPoolUsable) {
+  std::atomic<int> ran{0};
+  int submitted = 0;
+  {
+    lace::thread_pool pool(1);
+    // From outside: the first allocation makes the task, later ones grow the
+    // shared queue.
+    for (int allowed = 0; allowed < 4; ++allowed) {
+      allocations_left = allowed;
+      try {
+        pool.submit([&ran] { ran++; });
+        submitted++;
+      } catch (const std::bad_alloc&) {
+      }
+      allocations_left = -1;
+    }
+    EXPECT_LT(submitted, 4);
+
+    // From the only worker, so nothing steals: the 65th push grows its deque.
+    std::atomic<bool> done{false};
+    int failed = 0;
+    pool.submit([&] {
+      for (int i = 0; i < 64; ++i) pool.submit([&ran] { ran++; });
+      allocations_left = 1;
+      try {
+        pool.submit([&ran] { ran++; });
+      } catch (const std::bad_alloc&) {
+        failed++;
+      }
+      allocations_left = -1;
+      done = true;
+    });
+    while (!done) std::this_thread::yield();
+    EXPECT_EQ(failed, 1);
+  }
+  EXPECT_EQ(ran.load(), submitted + 64);
+}
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "../lace_queue.h"
+#include "../lace_unrolled_list.h"
+
+using SmallChunks = lace::unrolled_list<int, 4, 2>;
+
+namespace {
+
+// Copying throws once copies_left runs out; live counts the instances.
+struct counted {
+  static int live;
+  static int copies_left;
+
+  counted() { ++live; }
+  counted(const counted&) {
+    if (copies_left-- <= 0) throw std::runtime_error("copy failed");
+    ++live;
+  }
+  ~counted() { --live; }
+};
+
+int counted::live = 0;
+int counted::copies_left = 0;
+
+}  // namespace
+
+TEST(UnrolledListTest, FifoAcrossChunks) {
+  SmallChunks list;
+  EXPECT_TRUE(list.empty());
+  EXPECT_EQ(list.allocated_chunks(), 0);
+  for (int i = 0; i < 10; ++i) list.push_back(i);
+  EXPECT_EQ(list.size(), 10);
+  EXPECT_EQ(list.allocated_chunks(), 3);
+  EXPECT_EQ(list.front(), 0);
+  EXPECT_EQ(list.back(), 9);
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(list.front(), i);
+    list.pop_front();
+  }
+  EXPECT_TRUE(list.empty());
+  EXPECT_THROW(list.front(), std::out_of_range);
+  EXPECT_THROW(list.back(), std::out_of_range);
+  EXPECT_THROW(list.pop_front(), std::out_of_range);
+}
+
+TEST(UnrolledListTest, DrainedChunksAreCachedUpToTheBound) {
+  SmallChunks list;
+  // A spike to 25 chunks.
+  for (int i = 0; i < 100; ++i) list.push_back(i);
+  EXPECT_EQ(list.allocated_chunks(), 25);
+  for (int i = 0; i < 100; ++i) list.pop_front();
+  // The last chunk stays in place and two more are cached.
+  EXPECT_EQ(list.allocated_chunks(), 3);
+  // Cycling through up to three chunks reuses them.
+  for (int round = 0; round < 50; ++round) {
+    for (int i = 0; i < 12; ++i) list.push_back(i);
+    EXPECT_EQ(list.allocated_chunks(), 3);
+    for (int i = 0; i < 12; ++i) list.pop_front();
+  }
+  list.clear();
+  EXPECT_EQ(list.allocated_chunks(), 2);
+  list.shrink_to_fit();
+  EXPECT_EQ(list.allocated_chunks(), 0);
+}
+
+TEST(UnrolledListTest, CopyMoveAndOwnedElements) {
+  auto tracked = std::make_shared<int>(1);
+  {
+    lace::unrolled_list<std::shared_ptr<int>, 3> list;
+    for (int i = 0; i < 7; ++i) list.push_back(tracked);
+    list.pop_front();
+    auto copy = list;
+    EXPECT_EQ(copy.size(), 6);
+    EXPECT_EQ(tracked.use_count(), 13);
+    auto moved = std::move(copy);
+    EXPECT_TRUE(copy.empty());
+    moved.clear();
+    EXPECT_EQ(tracked.use_count(), 7);
+  }
+  EXPECT_EQ(tracked.use_count(), 1);
+
+  lace::unrolled_list<std::string, 2> strings{"a", "b", "c"};
+  strings = lace::unrolled_list<std::string, 2>{"x"};
+  strings.emplace_back(3, 'y');
+  EXPECT_EQ(strings.front(), "x");
+  EXPECT_EQ(strings.back(), "yyy");
+}
+
+TEST(UnrolledListTest, ThrowingCopyLeavesNothingBehind) {
+  {
+    lace::unrolled_list<counted, 2> list;
+    for (int i = 0; i < 5; ++i) list.emplace_back();
+    counted::copies_left = 3;
+    EXPECT_THROW((lace::unrolled_list<counted, 2>(list)), std::runtime_error);
+    EXPECT_EQ(counted::live, 5);
+    counted::copies_left = 1;
+    EXPECT_THROW((lace::unrolled_list<counted, 2>{counted(), counted()}),
+                 std::runtime_error);
+    EXPECT_EQ(counted::live, 5);
+  }
+  EXPECT_EQ(counted::live, 0);
+}
+
+TEST(UnrolledListTest, BacksChunkedQueue) {
+  lace::chunked_queue<int> q{1, 2, 3};
+  q.push(4);
+  q.pop();
+  EXPECT_EQ(q.front(), 2);
+  EXPECT_EQ(q.back(), 4);
+  EXPECT_EQ(q.size(), 3);
+}
@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "../lace_ws_deque.h"
+
+TEST(WsDequeTest, OwnerPopsNewestThiefStealsOldest) {
+  lace::ws_deque<int> d(2);
+  EXPECT_FALSE(d.pop().has_value());
+  EXPECT_FALSE(d.steal().has_value());
+  for (int i = 0; i < 100; ++i) d.push(i);
+  EXPECT_EQ(d.size(), 100);
+  EXPECT_EQ(d.pop(), 99);
+  EXPECT_EQ(d.steal(), 0);
+  EXPECT_EQ(d.steal(), 1);
+  EXPECT_EQ(d.pop(), 98);
+  EXPECT_EQ(d.size(), 96);
+  while (d.pop().has_value()) {
+  }
+  EXPECT_TRUE(d.empty());
+  d.push(7);
+  EXPECT_EQ(d.steal(), 7);
+  EXPECT_FALSE(d.pop().has_value());
+}
+
+TEST(WsDequeTest, EveryItemTakenExactlyOnce) {
+  const int items = 200000;
+  const int thieves = 3;
+  lace::ws_deque<int> d;
+  std::vector<std::atomic<int>> taken(items);
+  std::atomic<bool> done{false};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < thieves; ++t) {
+    threads.emplace_back([&] {
+      while (!done.load()) {
+        if (auto item = d.steal()) taken[*item]++;
+      }
+    });
+  }
+  for (int i = 0; i < items; ++i) {
+    d.push(i);
+    if (i % 3 == 0) {
+      if (auto item = d.pop()) taken[*item]++;
+    }
+  }
+  while (auto item = d.pop()) taken[*item]++;
+  done = true;
+  for (auto& thread : threads) thread.join();
+  while (auto item = d.steal()) taken[*item]++;
+  for (int i = 0; i < items; ++i) EXPECT_EQ(taken[i].load(), 1) << i;
+}
+
+TEST(WsDequeTest, RejectsCapacityPastTheLargestRing) {
+  using deque = lace::ws_deque<int*>;
+  EXPECT_NO_THROW(deque(1));
+  EXPECT_THROW(deque(deque::max_capacity() + 1), std::length_error);
+  EXPECT_THROW(deque(SIZE_MAX), std::length_error);
+}